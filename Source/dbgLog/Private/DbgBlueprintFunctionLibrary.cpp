@@ -21,6 +21,32 @@
 
 #include "DbgBlueprintFunctionLibrary.h"
 
+#include "UObject/Script.h"
+
+
+#if KEEP_DBG_LOG
+namespace
+{
+	// Without an explicit key, the same blueprint node keeps updating its own screen message.
+	uint64 GetBlueprintScreenKey()
+	{
+#if DO_BLUEPRINT_GUARD
+		const TArrayView<const FFrame* const> ScriptStack = FBlueprintContextTracking::Get().GetCurrentScriptStack();
+		if (ScriptStack.Num() > 0 && ScriptStack.Last() && ScriptStack.Last()->Node)
+		{
+			const FFrame* Frame = ScriptStack.Last();
+			const uint64 CodeOffset = Frame->Code - Frame->Node->Script.GetData();
+			return DBG::Log::HashCallsiteValue(DBG::Log::HashCallsiteValue(0xcbf29ce484222325ull,
+				reinterpret_cast<UPTRINT>(Frame->Node)), CodeOffset);
+		}
+#endif
+		// No way to tell the nodes apart, every log gets its own line like before.
+		static std::atomic<uint64> NextKey{0};
+		return NextKey.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+#endif
+
 
 
 void UDbgBlueprintFunctionLibrary::OutputLog(UObject* WorldContextObject,
@@ -68,10 +94,15 @@ void UDbgBlueprintFunctionLibrary::OutputLog(UObject* WorldContextObject,
 		LogArgs.LogToEditorMessageLog( LogExtraArgs.bShouldShowEditorMessageLogImmediately );
 	}
 
-	
-	DBG::Log::Log( LogExtraArgs.ScreenKey != -1 ?
-		LogExtraArgs.ScreenKey : FMath::Rand32(),
-		std::source_location::current(), LogArgs,
-		TEXT("{0}"), LogMessage );
+	LogArgs.ScrnKey( LogExtraArgs.ScreenKey != -1 ? static_cast<uint64>(LogExtraArgs.ScreenKey) : GetBlueprintScreenKey() );
+
+	// Every blueprint log goes through this one callsite, the category cache still helps when the same name repeats.
+	static DBG::Log::FDbgLogCallsite Callsite{ std::source_location::current() };
+	if ( LogArgs.ShouldLog( Callsite ) == false )
+	{
+		return;
+	}
+
+	DBG::Log::Log( Callsite, LogArgs, TEXT("{0}"), LogMessage );
 #endif
 }
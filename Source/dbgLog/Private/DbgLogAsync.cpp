@@ -0,0 +1,249 @@
+// Copyright ©  Jack Holland.
+//
+// DbgLOG is free software. It comes without any warranty, to the extent permitted
+// by applicable law. You can redistribute it and/or modify it under the terms
+// of the Do What The Fuck You Want To Public License, Version 2, as published
+// by Sam Hocevar:
+//
+//            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+//                    Version 2, December 2004
+//
+// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+//
+// Everyone is permitted to copy and distribute verbatim or modified
+// copies of this license document, and changing it is allowed as long
+// as the name is changed.
+//
+//            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+//   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+//
+//  0. You just DO WHAT THE FUCK YOU WANT TO.
+
+#include "DbgLogAsync.h"
+#include "dbgLog.h" // Relative path that must be updated if you move the files location.
+
+#include "HAL/Event.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/CommandLine.h"
+#include "Misc/OutputDeviceRedirector.h"
+
+
+#if KEEP_DBG_LOG
+
+static bool GDbgLogAsyncEnabled = false;
+static FAutoConsoleVariableRef CVarDbgLogAsync
+	{
+		TEXT("dbgLog.Async"),
+		GDbgLogAsyncEnabled,
+		TEXT("If true, dbgLOG hands console logs to a background writer thread instead of writing them on the calling thread."),
+		FConsoleVariableDelegate::CreateLambda([](IConsoleVariable* Variable)
+		{
+			DBG::Log::GDbgLogAsyncBackend.SetEnabled(Variable->GetBool());
+		})
+	};
+
+static bool GDbgLogAsyncDeferFormatting = false;
+static FAutoConsoleVariableRef CVarDbgLogAsyncDeferFormatting
+	{
+		TEXT("dbgLog.Async.DeferFormatting"),
+		GDbgLogAsyncDeferFormatting,
+		TEXT("If true (and dbgLog.Async is on), console logs whose arguments are all trivially copyable (numbers, enums, FName, FVector...) ")
+		TEXT("only capture their raw arguments and get formatted on the writer thread."),
+		FConsoleVariableDelegate::CreateLambda([](IConsoleVariable* Variable)
+		{
+			DBG::Log::GDbgLogAsyncBackend.SetDeferFormatting(Variable->GetBool());
+		})
+	};
+
+FAutoConsoleCommand FlushCommand
+	{
+		TEXT("dbgLog.Flush"),
+		TEXT("Blocks until every log queued by the async backend has been written out, and flushes the binary log file."),
+		FConsoleCommandDelegate::CreateLambda([]()
+		{
+			DBG::Log::GDbgLogAsyncBackend.Flush();
+			DBG::Log::GDbgLogBinarySink.Flush();
+			GLog->Flush();
+		}),
+		ECVF_Cheat
+	};
+
+
+
+namespace DBG::Log
+{
+	FDbgLogAsyncBackend GDbgLogAsyncBackend;
+
+	FDbgLogAsyncBackend::FDbgLogAsyncBackend() = default;
+
+	FDbgLogAsyncBackend::~FDbgLogAsyncBackend()
+	{
+		// The module shuts us down properly, this is only here in case it never got the chance.
+		if (Thread)
+		{
+			SetEnabled(false);
+		}
+
+		delete WakeEvent;
+	}
+
+	void FDbgLogAsyncBackend::StartupModule()
+	{
+		SetDeferFormatting(GDbgLogAsyncDeferFormatting || FParse::Param(FCommandLine::Get(), TEXT("dbgLogDeferFormatting")));
+
+		if (GDbgLogAsyncEnabled || FParse::Param(FCommandLine::Get(), TEXT("dbgLogAsync")))
+		{
+			SetEnabled(true);
+		}
+	}
+
+	void FDbgLogAsyncBackend::ShutdownModule()
+	{
+		SetEnabled(false);
+	}
+
+	void FDbgLogAsyncBackend::SetEnabled(bool bEnabled)
+	{
+		FScopeLock ScopeLock(&StateLock);
+		if (bEnabled == (Thread != nullptr))
+		{
+			return;
+		}
+
+		if (bEnabled)
+		{
+			bStopping.store(false, std::memory_order_relaxed);
+
+			// Kept until we're destroyed, producers that raced with a disable may still trigger it.
+			if (WakeEvent == nullptr)
+			{
+				WakeEvent = FPlatformProcess::CreateSynchEvent(false);
+			}
+
+			Thread = FRunnableThread::Create(this, TEXT("dbgLogWriter"), 0, TPri_BelowNormal);
+			if (Thread == nullptr)
+			{
+				// No threading support, stay synchronous.
+				return;
+			}
+			bActive.store(true, std::memory_order_release);
+		}
+		else
+		{
+			// New logs go straight to the output devices again from here on.
+			bActive.store(false, std::memory_order_release);
+
+			Thread->Kill(true);
+			delete Thread;
+			Thread = nullptr;
+
+			// Whatever got queued while we were stopping.
+			Drain();
+			ReportDropped();
+		}
+	}
+
+	bool FDbgLogAsyncBackend::Enqueue(FDbgLogRecord&& Record)
+	{
+		if (Queue.TryEnqueue(MoveTemp(Record)) == false)
+		{
+			DroppedCount.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+
+		// Only the first record after the writer caught up has to wake it, it drains everything else in the same go.
+		const bool bWasEmpty = EnqueuedCount.fetch_add(1, std::memory_order_release) == WrittenCount.load(std::memory_order_acquire);
+
+		// We raced with the backend being disabled, nobody else is going to pick this one up.
+		if (bActive.load(std::memory_order_acquire) == false)
+		{
+			Drain();
+		}
+		else if (bWasEmpty)
+		{
+			// Set before bActive was, and never freed while we're around.
+			WakeEvent->Trigger();
+		}
+		return true;
+	}
+
+	void FDbgLogAsyncBackend::Flush()
+	{
+		if (IsActive() == false)
+		{
+			return;
+		}
+
+		// The writer never sleeps for long, so just wait for it to catch up.
+		const uint64 Target = EnqueuedCount.load(std::memory_order_acquire);
+		while (WrittenCount.load(std::memory_order_acquire) < Target && IsActive())
+		{
+			FPlatformProcess::SleepNoStats(0.f);
+		}
+	}
+
+	uint32 FDbgLogAsyncBackend::Run()
+	{
+		while (bStopping.load(std::memory_order_relaxed) == false)
+		{
+			if (Drain() == 0)
+			{
+				ReportDropped();
+				WakeEvent->Wait(5);
+			}
+		}
+		return 0;
+	}
+
+	void FDbgLogAsyncBackend::Stop()
+	{
+		bStopping.store(true, std::memory_order_relaxed);
+		WakeEvent->Trigger();
+	}
+
+	int32 FDbgLogAsyncBackend::Drain()
+	{
+		FScopeLock ScopeLock(&DrainLock);
+
+		int32 NumWritten = 0;
+		FDbgLogRecord Record;
+		TStringBuilder<1024> DatedBuilder;
+		while (Queue.TryDequeue(Record))
+		{
+			DBGLOG_TRACE_SCOPE(AsyncWrite);
+			if (Record.FormatFunc)
+			{
+				Record.FormatFunc(Record.Format, Record.ArgData.GetData(), Record.Message);
+			}
+
+			const TCHAR* Message = *Record.Message;
+			if (Record.bLogDateAndTime)
+			{
+				DatedBuilder.Reset();
+				DatedBuilder << TEXT("(");
+				AppendDateTime(DatedBuilder, Record.Cycles, Record.DateTimeFormat);
+				DatedBuilder << TEXT(") ") << Record.Message;
+				Message = DatedBuilder.ToString();
+			}
+
+			check(Record.LogRecord);
+			::UE::Logging::Private::BasicLog(*Record.Category, Record.LogRecord, Message);
+
+			++NumWritten;
+			WrittenCount.fetch_add(1, std::memory_order_release);
+		}
+		return NumWritten;
+	}
+
+	void FDbgLogAsyncBackend::ReportDropped()
+	{
+		const uint64 Dropped = DroppedCount.load(std::memory_order_relaxed);
+		if (Dropped != ReportedDroppedCount)
+		{
+			UE_LOG(dbgLOG, Warning, TEXT("Async log queue was full, dropped %llu logs."), Dropped - ReportedDroppedCount);
+			ReportedDroppedCount = Dropped;
+		}
+	}
+}
+
+#endif
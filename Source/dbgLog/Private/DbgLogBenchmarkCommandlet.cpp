@@ -0,0 +1,707 @@
+// Copyright ©  Jack Holland.
+//
+// DbgLOG is free software. It comes without any warranty, to the extent permitted
+// by applicable law. You can redistribute it and/or modify it under the terms
+// of the Do What The Fuck You Want To Public License, Version 2, as published
+// by Sam Hocevar:
+//
+//            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+//                    Version 2, December 2004
+//
+// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+//
+// Everyone is permitted to copy and distribute verbatim or modified
+// copies of this license document, and changing it is allowed as long
+// as the name is changed.
+//
+//            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+//   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+//
+//  0. You just DO WHAT THE FUCK YOU WANT TO.
+
+#include "DbgLogBenchmarkCommandlet.h"
+#include "dbgLog.h" // Relative path that must be updated if you move the files location.
+#include "DbgBlueprintFunctionLibrary.h"
+
+#include "Async/Async.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/MemoryBase.h"
+#include "Interfaces/IPluginManager.h"
+#include "Logging/StructuredLog.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+
+DEFINE_LOG_CATEGORY_STATIC(LogDbgLogBenchmark, Display, All);
+DEFINE_LOG_CATEGORY_STATIC(LogDbgLogBenchmarkDisabled, Display, All);
+// The closest a UE_LOG category gets to being disabled, turned off at runtime like `Log LogDbgLogBenchmarkOff off` would.
+DEFINE_LOG_CATEGORY_STATIC(LogDbgLogBenchmarkOff, NoLogging, All);
+
+
+UDbgLogBenchmarkCommandlet::UDbgLogBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+
+#if KEEP_DBG_LOG
+
+namespace
+{
+	/**
+	 * Forwards everything to the real allocator, counting how often it's asked for memory by the threads running a
+	 * benchmark loop. The rest of the engine (the log writer, the task graph...) keeps allocating in the background and
+	 * isn't what's being measured.
+	 */
+	class FDbgLogCountingMalloc final : public FMalloc
+	{
+	public:
+		explicit FDbgLogCountingMalloc(FMalloc* InInner)
+			: Inner(InInner)
+		{
+		}
+
+		uint64 GetAllocations() const { return Allocations.load(std::memory_order_relaxed); }
+
+		// Only allocations made on a thread while this is set are counted.
+		static void SetCountingOnThisThread(bool bCount) { bCountOnThisThread = bCount; }
+
+		//~ FMalloc
+		virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+		{
+			if (bCountOnThisThread)
+			{
+				Allocations.fetch_add(1, std::memory_order_relaxed);
+			}
+			return Inner->Malloc(Count, Alignment);
+		}
+
+		virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			if (bCountOnThisThread && Count > 0)
+			{
+				Allocations.fetch_add(1, std::memory_order_relaxed);
+			}
+			return Inner->Realloc(Original, Count, Alignment);
+		}
+
+		virtual void Free(void* Original) override { Inner->Free(Original); }
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return Inner->QuantizeSize(Count, Alignment); }
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+		virtual void Trim(bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+		virtual void SetupTLSCachesOnCurrentThread() override { Inner->SetupTLSCachesOnCurrentThread(); }
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override { Inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+		virtual void UpdateStats() override { Inner->UpdateStats(); }
+		virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override { Inner->GetAllocatorStats(OutStats); }
+		virtual void DumpAllocatorStats(FOutputDevice& Ar) override { Inner->DumpAllocatorStats(Ar); }
+		virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+		virtual bool ValidateHeap() override { return Inner->ValidateHeap(); }
+		virtual const TCHAR* GetDescriptiveName() override { return TEXT("DbgLogCountingMalloc"); }
+		//~ FMalloc
+
+	private:
+		FMalloc* Inner;
+		std::atomic<uint64> Allocations{0};
+		static thread_local bool bCountOnThisThread;
+	};
+
+	thread_local bool FDbgLogCountingMalloc::bCountOnThisThread = false;
+
+
+	struct FBenchmarkResult
+	{
+		FString Name;
+		FString Implementation;
+		int32 NumThreads = 1;
+		int64 Iterations = 0;
+		int32 Repetitions = 1;
+		double NsPerCall = 0.0;
+		double CallsPerSecond = 0.0;
+		double AllocationsPerCall = 0.0;
+	};
+
+
+	class FBenchmarkRunner
+	{
+	public:
+		FBenchmarkRunner(FDbgLogCountingMalloc& InCounter, int64 InIterations, int32 InRepetitions)
+			: Counter(InCounter)
+			, Iterations(InIterations)
+			, Repetitions(InRepetitions)
+		{
+		}
+
+		/**
+		 * Runs Body(Index) Iterations times on each of NumThreads threads, Repetitions times over, and keeps the median
+		 * repetition so a single preempted run doesn't decide the result. NsPerCall is what a single call cost the thread
+		 * making it (so it goes up with contention), CallsPerSecond is the throughput of all threads together.
+		 */
+		template<typename FuncType>
+		void Run(const TCHAR* Name, const TCHAR* Implementation, int32 NumThreads, const FuncType& Body)
+		{
+			// The first calls register the callsite, resolve the category...
+			for (int64 Index = 0; Index < 16; ++Index)
+			{
+				Body(Index);
+			}
+
+			TArray<FBenchmarkResult, TInlineAllocator<16>> Runs;
+			for (int32 Repetition = 0; Repetition < Repetitions; ++Repetition)
+			{
+				Runs.Add(RunOnce(NumThreads, Body));
+			}
+			Runs.Sort([](const FBenchmarkResult& A, const FBenchmarkResult& B) { return A.NsPerCall < B.NsPerCall; });
+
+			FBenchmarkResult& Result = Results.Add_GetRef(Runs[Runs.Num() / 2]);
+			Result.Name = Name;
+			Result.Implementation = Implementation;
+		}
+
+		const TArray<FBenchmarkResult>& GetResults() const { return Results; }
+
+	private:
+		template<typename FuncType>
+		FBenchmarkResult RunOnce(int32 NumThreads, const FuncType& Body) const
+		{
+			TArray<uint64> StartCycles, EndCycles;
+			StartCycles.SetNumZeroed(NumThreads);
+			EndCycles.SetNumZeroed(NumThreads);
+
+			const uint64 AllocationsBefore = Counter.GetAllocations();
+			if (NumThreads == 1)
+			{
+				RunLoop(Body, StartCycles[0], EndCycles[0]);
+			}
+			else
+			{
+				// Real threads rather than the task graph, so they really all hammer the same code at the same time.
+				std::atomic<int32> NumReady{0};
+				TArray<TFuture<void>> Threads;
+				for (int32 ThreadIndex = 0; ThreadIndex < NumThreads; ++ThreadIndex)
+				{
+					Threads.Add(Async(EAsyncExecution::Thread, [&, ThreadIndex]()
+					{
+						NumReady.fetch_add(1);
+						while (NumReady.load() < NumThreads)
+						{
+							FPlatformProcess::YieldThread();
+						}
+						RunLoop(Body, StartCycles[ThreadIndex], EndCycles[ThreadIndex]);
+					}));
+				}
+
+				for (TFuture<void>& Thread : Threads)
+				{
+					Thread.Wait();
+				}
+			}
+			const uint64 Allocations = Counter.GetAllocations() - AllocationsBefore;
+
+			uint64 ThreadCycles = 0;
+			uint64 FirstStart = MAX_uint64;
+			uint64 LastEnd = 0;
+			for (int32 ThreadIndex = 0; ThreadIndex < NumThreads; ++ThreadIndex)
+			{
+				ThreadCycles += EndCycles[ThreadIndex] - StartCycles[ThreadIndex];
+				FirstStart = FMath::Min(FirstStart, StartCycles[ThreadIndex]);
+				LastEnd = FMath::Max(LastEnd, EndCycles[ThreadIndex]);
+			}
+
+			const double SecondsPerCycle = FPlatformTime::GetSecondsPerCycle64();
+			const double TotalCalls = static_cast<double>(Iterations) * NumThreads;
+
+			FBenchmarkResult Result;
+			Result.NumThreads = NumThreads;
+			Result.Iterations = Iterations;
+			Result.Repetitions = Repetitions;
+			Result.NsPerCall = ThreadCycles * SecondsPerCycle * 1e9 / TotalCalls;
+			Result.CallsPerSecond = TotalCalls / FMath::Max((LastEnd - FirstStart) * SecondsPerCycle, UE_DOUBLE_SMALL_NUMBER);
+			Result.AllocationsPerCall = Allocations / TotalCalls;
+			return Result;
+		}
+
+		template<typename FuncType>
+		void RunLoop(const FuncType& Body, uint64& OutStart, uint64& OutEnd) const
+		{
+			FDbgLogCountingMalloc::SetCountingOnThisThread(true);
+			OutStart = FPlatformTime::Cycles64();
+			for (int64 Index = 0; Index < Iterations; ++Index)
+			{
+				Body(Index);
+			}
+			OutEnd = FPlatformTime::Cycles64();
+			FDbgLogCountingMalloc::SetCountingOnThisThread(false);
+		}
+
+		FDbgLogCountingMalloc& Counter;
+		const int64 Iterations;
+		const int32 Repetitions;
+		TArray<FBenchmarkResult> Results;
+	};
+
+
+	FString ResultsToJson(const TArray<FBenchmarkResult>& Results)
+	{
+		FString Json = FString::Printf(TEXT("{\n\t\"engine\": \"%s\",\n\t\"platform\": \"%s\",\n\t\"results\": [\n"),
+			*FEngineVersion::Current().ToString(), ANSI_TO_TCHAR(FPlatformProperties::IniPlatformName()));
+
+		for (int32 Index = 0; Index < Results.Num(); ++Index)
+		{
+			const FBenchmarkResult& Result = Results[Index];
+			Json += FString::Printf(TEXT("\t\t{\"name\": \"%s\", \"implementation\": \"%s\", \"threads\": %d, \"iterations\": %lld, \"repetitions\": %d, ")
+				TEXT("\"ns_per_call\": %.2f, \"calls_per_second\": %.0f, \"allocations_per_call\": %.3f}%s\n"),
+				*Result.Name, *Result.Implementation, Result.NumThreads, Result.Iterations, Result.Repetitions,
+				Result.NsPerCall, Result.CallsPerSecond, Result.AllocationsPerCall, Index + 1 < Results.Num() ? TEXT(",") : TEXT(""));
+		}
+
+		Json += TEXT("\t]\n}\n");
+		return Json;
+	}
+
+
+	// The log cases, each dbgLOG next to the UE_LOG/UE_LOGFMT doing the same work.
+	void RunLogBenchmarks(FBenchmarkRunner& Runner, UWorld* World)
+	{
+		// Registered up front so disabling it doesn't warn about a missing category.
+		DBG::Log::GDbgLogSingleton.FindOrAddCategoryId(LogDbgLogBenchmarkDisabled.GetCategoryName());
+		DBG::Log::GDbgLogSingleton.SetCategoryState<false>(LogDbgLogBenchmarkDisabled.GetCategoryName(), false);
+
+		TArray<int32> Container;
+		for (int32 Index = 0; Index < 16; ++Index)
+		{
+			Container.Add(Index * 7);
+		}
+		const FVector Vector(1.0, 2.0, 3.0);
+
+		// Read at runtime so the compiler can't throw the UE_LOG baselines away.
+		volatile bool bCondition = false;
+
+		// Logs that never make it anywhere.
+		Runner.Run(TEXT("DisabledCategory"), TEXT("dbgLOG"), 1, [](int64 Index)
+		{
+			dbgLOGV(.Category(LogDbgLogBenchmarkDisabled), "Value {0}", Index);
+		});
+		Runner.Run(TEXT("DisabledCategory"), TEXT("UE_LOG"), 1, [](int64 Index)
+		{
+			UE_LOG(LogDbgLogBenchmarkOff, Display, TEXT("Value %lld"), Index);
+		});
+		Runner.Run(TEXT("DisabledCategory"), TEXT("UE_LOGFMT"), 1, [](int64 Index)
+		{
+			UE_LOGFMT(LogDbgLogBenchmarkOff, Display, "Value {Value}", Index);
+		});
+		Runner.Run(TEXT("SuppressedVerbosity"), TEXT("dbgLOG"), 1, [](int64 Index)
+		{
+			dbgLOGV(.Category(LogDbgLogBenchmark).Verbose(), "Value {0}", Index);
+		});
+		Runner.Run(TEXT("SuppressedVerbosity"), TEXT("UE_LOG"), 1, [](int64 Index)
+		{
+			UE_LOG(LogDbgLogBenchmark, Verbose, TEXT("Value %lld"), Index);
+		});
+		Runner.Run(TEXT("SuppressedVerbosity"), TEXT("UE_LOGFMT"), 1, [](int64 Index)
+		{
+			UE_LOGFMT(LogDbgLogBenchmark, Verbose, "Value {Value}", Index);
+		});
+		Runner.Run(TEXT("FalseCondition"), TEXT("dbgLOG"), 1, [&bCondition](int64 Index)
+		{
+			dbgLOGV(.Category(LogDbgLogBenchmark).Condition(bCondition), "Value {0}", Index);
+		});
+		Runner.Run(TEXT("FalseCondition"), TEXT("UE_LOG"), 1, [&bCondition](int64 Index)
+		{
+			if (bCondition)
+			{
+				UE_LOG(LogDbgLogBenchmark, Display, TEXT("Value %lld"), Index);
+			}
+		});
+		Runner.Run(TEXT("FalseCondition"), TEXT("UE_LOGFMT"), 1, [&bCondition](int64 Index)
+		{
+			if (bCondition)
+			{
+				UE_LOGFMT(LogDbgLogBenchmark, Display, "Value {Value}", Index);
+			}
+		});
+
+		// Plain console logs, also from several threads at once.
+		for (const int32 NumThreads : {1, 4, 16})
+		{
+			Runner.Run(TEXT("Console"), TEXT("dbgLOG"), NumThreads, [](int64 Index)
+			{
+				dbgLOGV(.Category(LogDbgLogBenchmark), "Value {0}", Index);
+			});
+			Runner.Run(TEXT("Console"), TEXT("UE_LOG"), NumThreads, [](int64 Index)
+			{
+				UE_LOG(LogDbgLogBenchmark, Display, TEXT("Value %lld"), Index);
+			});
+			Runner.Run(TEXT("Console"), TEXT("UE_LOGFMT"), NumThreads, [](int64 Index)
+			{
+				UE_LOGFMT(LogDbgLogBenchmark, Display, "Value {Value}", Index);
+			});
+		}
+
+		// The builder options, the baselines build the same prefix by hand (a category by name has to be declared instead).
+		Runner.Run(TEXT("NamedCategory"), TEXT("dbgLOG"), 1, [](int64 Index)
+		{
+			dbgLOGV(.Category("Benchmark"), "Value {0}", Index);
+		});
+		Runner.Run(TEXT("NamedCategory"), TEXT("UE_LOG"), 1, [](int64 Index)
+		{
+			UE_LOG(LogDbgLogBenchmark, Display, TEXT("Value %lld"), Index);
+		});
+		Runner.Run(TEXT("NamedCategory"), TEXT("UE_LOGFMT"), 1, [](int64 Index)
+		{
+			UE_LOGFMT(LogDbgLogBenchmark, Display, "Value {Value}", Index);
+		});
+		Runner.Run(TEXT("WorldContext"), TEXT("dbgLOG"), 1, [World](int64 Index)
+		{
+			dbgLOGV(.Category(LogDbgLogBenchmark).WCO(World), "Value {0}", Index);
+		});
+		Runner.Run(TEXT("WorldContext"), TEXT("UE_LOG"), 1, [World](int64 Index)
+		{
+			const FWorldContext* Context = GEngine->GetWorldContextFromWorld(World);
+			UE_LOG(LogDbgLogBenchmark, Display, TEXT("[%d | Instance: %d] Value %lld"),
+				static_cast<int32>(World->GetNetMode()), Context ? Context->PIEInstance : INDEX_NONE, Index);
+		});
+		Runner.Run(TEXT("WorldContext"), TEXT("UE_LOGFMT"), 1, [World](int64 Index)
+		{
+			const FWorldContext* Context = GEngine->GetWorldContextFromWorld(World);
+			UE_LOGFMT(LogDbgLogBenchmark, Display, "[{NetMode} | Instance: {Instance}] Value {Value}",
+				static_cast<int32>(World->GetNetMode()), Context ? Context->PIEInstance : INDEX_NONE, Index);
+		});
+		Runner.Run(TEXT("SourceLocation"), TEXT("dbgLOG"), 1, [](int64 Index)
+		{
+			dbgLOGV(.Category(LogDbgLogBenchmark).LogSourceLoc(), "Value {0}", Index);
+		});
+		Runner.Run(TEXT("SourceLocation"), TEXT("UE_LOG"), 1, [](int64 Index)
+		{
+			UE_LOG(LogDbgLogBenchmark, Display, TEXT("[File: %s (%d), %s] Value %lld"),
+				*FPaths::GetCleanFilename(ANSI_TO_TCHAR(__FILE__)), __LINE__, ANSI_TO_TCHAR(__FUNCTION__), Index);
+		});
+		Runner.Run(TEXT("SourceLocation"), TEXT("UE_LOGFMT"), 1, [](int64 Index)
+		{
+			UE_LOGFMT(LogDbgLogBenchmark, Display, "[File: {File} ({Line}), {Function}] Value {Value}",
+				FPaths::GetCleanFilename(ANSI_TO_TCHAR(__FILE__)), __LINE__, ANSI_TO_TCHAR(__FUNCTION__), Index);
+		});
+		Runner.Run(TEXT("DateAndTime"), TEXT("dbgLOG"), 1, [](int64 Index)
+		{
+			dbgLOGV(.Category(LogDbgLogBenchmark).LogDateAndTime(), "Value {0}", Index);
+		});
+		Runner.Run(TEXT("DateAndTime"), TEXT("UE_LOG"), 1, [](int64 Index)
+		{
+			UE_LOG(LogDbgLogBenchmark, Display, TEXT("[%s] Value %lld"), *FDateTime::Now().ToString(), Index);
+		});
+		Runner.Run(TEXT("DateAndTime"), TEXT("UE_LOGFMT"), 1, [](int64 Index)
+		{
+			UE_LOGFMT(LogDbgLogBenchmark, Display, "[{Time}] Value {Value}", FDateTime::Now().ToString(), Index);
+		});
+
+		// Arguments that need more than a number, the baselines do what you'd have to write by hand instead.
+		Runner.Run(TEXT("ContainerArgument"), TEXT("dbgLOG"), 1, [&Container](int64 Index)
+		{
+			dbgLOGV(.Category(LogDbgLogBenchmark), "Values {0}", Container);
+		});
+		Runner.Run(TEXT("ContainerArgument"), TEXT("UE_LOG"), 1, [&Container](int64 Index)
+		{
+			UE_LOG(LogDbgLogBenchmark, Display, TEXT("Values [%s]"), *FString::JoinBy(Container, TEXT(", "), [](int32 Value) { return FString::FromInt(Value); }));
+		});
+		Runner.Run(TEXT("ContainerArgument"), TEXT("UE_LOGFMT"), 1, [&Container](int64 Index)
+		{
+			UE_LOGFMT(LogDbgLogBenchmark, Display, "Values [{Values}]", FString::JoinBy(Container, TEXT(", "), [](int32 Value) { return FString::FromInt(Value); }));
+		});
+		Runner.Run(TEXT("StructArgument"), TEXT("dbgLOG"), 1, [&Vector](int64 Index)
+		{
+			dbgLOGV(.Category(LogDbgLogBenchmark), "Vector {0}", Vector);
+		});
+		Runner.Run(TEXT("StructArgument"), TEXT("UE_LOG"), 1, [&Vector](int64 Index)
+		{
+			UE_LOG(LogDbgLogBenchmark, Display, TEXT("Vector %s"), *Vector.ToString());
+		});
+		Runner.Run(TEXT("StructArgument"), TEXT("UE_LOGFMT"), 1, [&Vector](int64 Index)
+		{
+			UE_LOGFMT(LogDbgLogBenchmark, Display, "Vector {Vector}", Vector.ToString());
+		});
+		Runner.Run(TEXT("ObjectArgument"), TEXT("dbgLOG"), 1, [World](int64 Index)
+		{
+			dbgLOGV(.Category(LogDbgLogBenchmark), "Object {0}", World);
+		});
+		Runner.Run(TEXT("ObjectArgument"), TEXT("UE_LOG"), 1, [World](int64 Index)
+		{
+			UE_LOG(LogDbgLogBenchmark, Display, TEXT("Object %s"), *GetNameSafe(World));
+		});
+		Runner.Run(TEXT("ObjectArgument"), TEXT("UE_LOGFMT"), 1, [World](int64 Index)
+		{
+			UE_LOGFMT(LogDbgLogBenchmark, Display, "Object {Object}", GetNameSafe(World));
+		});
+	}
+
+
+	/**
+	 * One case per FormatArgument branch (and the std::formatter specializations that skip it), each formats a single
+	 * argument into a reused builder so only the conversion itself is measured. The name is what the baseline is keyed on.
+	 */
+	void RunFormatterBenchmarks(FBenchmarkRunner& Runner, UWorld* World)
+	{
+		TStringBuilder<4096> Builder;
+		const auto Format = [&Runner, &Builder](const TCHAR* Name, const TCHAR* Branch, const auto& Value)
+		{
+			Runner.Run(Name, Branch, 1, [&Builder, &Value](int64 Index)
+			{
+				Builder.Reset();
+				DBG::Log::FormatMessageTo(Builder, L"{}", Value);
+			});
+		};
+
+		const int32 Number = 42;
+		const FString ShortString(TEXT("Short string"));
+		const FString LongString = FString::ChrN(1024, TEXT('x'));
+		const FName SomeName(TEXT("SomeName"), 7);
+		const FText Text = FText::FromString(TEXT("Some text"));
+		const std::string StdString("A std::string");
+		const FVector Vector(1.0, 2.0, 3.0);
+		const FDbgLogArgs Struct;
+		const EDbgLogVerbosity UEnumClass = EDbgLogVerbosity::Warning;
+		const TEnumAsByte<EDbgLogOutput> EnumAsByte = EDbgLogOutput::Both;
+		const EAsyncExecution PlainEnum = EAsyncExecution::ThreadPool;
+		const TTuple<int32, FString, FVector> Tuple(7, ShortString, Vector);
+
+		TArray<int32> Array;
+		TArray<TArray<int32>> NestedArray;
+		for (int32 Outer = 0; Outer < 8; ++Outer)
+		{
+			TArray<int32>& Inner = NestedArray.AddDefaulted_GetRef();
+			for (int32 Index = 0; Index < 8; ++Index)
+			{
+				Array.Add(Outer * 8 + Index);
+				Inner.Add(Outer * 8 + Index);
+			}
+		}
+
+		TMap<FName, FDbgLogArgs> StructMap;
+		for (int32 Index = 0; Index < 16; ++Index)
+		{
+			StructMap.Add(FName(TEXT("Entry"), Index));
+		}
+
+		Format(TEXT("Int32"), TEXT("std::format"), Number);
+		Format(TEXT("ShortFString"), TEXT("formatter<FString>"), ShortString);
+		Format(TEXT("LongFString"), TEXT("formatter<FString>"), LongString);
+		Format(TEXT("FName"), TEXT("formatter<FName>"), SomeName);
+		Format(TEXT("FText"), TEXT("formatter<FText>"), Text);
+		Format(TEXT("ObjectPointer"), TEXT("formatter<UObject*>"), World);
+		Format(TEXT("ObjectReference"), TEXT("GetName"), *World);
+		Format(TEXT("Vector"), TEXT("ToString"), Vector);
+		Format(TEXT("StdString"), TEXT("c_str"), StdString);
+		Format(TEXT("ReflectedStruct"), TEXT("ExportText"), Struct);
+		Format(TEXT("UEnumClass"), TEXT("UEnum"), UEnumClass);
+		Format(TEXT("EnumAsByte"), TEXT("TEnumAsByte"), EnumAsByte);
+		Format(TEXT("PlainEnum"), TEXT("LexToString"), PlainEnum);
+		Format(TEXT("IntArray"), TEXT("TFormatRange"), Array);
+		Format(TEXT("NestedArray"), TEXT("TFormatRange"), NestedArray);
+		Format(TEXT("StructMap"), TEXT("TFormatRange"), StructMap);
+		Format(TEXT("Tuple"), TEXT("TFormatTuple"), Tuple);
+	}
+
+
+	// The checked in baseline, `<Case>=<ns per call>` lines and an optional `Tolerance=` (0.25 fails anything 25% slower).
+	struct FFormatterBaseline
+	{
+		double Tolerance = 0.25;
+		TMap<FString, double> NsPerCall;
+	};
+
+	FString GetDefaultBaselinePath()
+	{
+		const TSharedPtr<IPlugin> Plugin = IPluginManager::Get().FindPlugin(TEXT("dbgLog"));
+		return Plugin ? Plugin->GetBaseDir() / TEXT("Config") / TEXT("DbgLogFormatterBaseline.ini") : FString();
+	}
+
+	bool LoadBaseline(const FString& Path, FFormatterBaseline& OutBaseline)
+	{
+		TArray<FString> Lines;
+		if (Path.IsEmpty() || FFileHelper::LoadFileToStringArray(Lines, *Path) == false)
+		{
+			return false;
+		}
+
+		for (FString& Line : Lines)
+		{
+			Line.TrimStartAndEndInline();
+			FString Key, Value;
+			if (Line.StartsWith(TEXT(";")) || Line.StartsWith(TEXT("[")) || Line.Split(TEXT("="), &Key, &Value) == false)
+			{
+				continue;
+			}
+
+			Key.TrimEndInline();
+			const double Number = FCString::Atod(*Value.TrimStart());
+			if (Key == TEXT("Tolerance"))
+			{
+				OutBaseline.Tolerance = Number;
+			}
+			else
+			{
+				OutBaseline.NsPerCall.Add(Key, Number);
+			}
+		}
+		return true;
+	}
+
+	bool SaveBaseline(const FString& Path, const TArray<FBenchmarkResult>& Results, double Tolerance)
+	{
+		FString Ini = TEXT("; Written by `-run=DbgLogBenchmark -formatters -updatebaseline`, the numbers only mean something on the machine that recorded them.\n");
+		Ini += TEXT("; <Case>=<ns per call>, a run fails when a case is more than Tolerance slower than this.\n");
+		Ini += FString::Printf(TEXT("[Formatters]\nTolerance=%.2f\n"), Tolerance);
+		for (const FBenchmarkResult& Result : Results)
+		{
+			Ini += FString::Printf(TEXT("%s=%.2f\n"), *Result.Name, Result.NsPerCall);
+		}
+		return Path.IsEmpty() == false && FFileHelper::SaveStringToFile(Ini, *Path);
+	}
+
+	// Returns how many cases regressed past the tolerance, with bRequireBaseline a case without an entry counts as one too.
+	int32 CheckBaseline(const FFormatterBaseline& Baseline, const TArray<FBenchmarkResult>& Results, bool bRequireBaseline)
+	{
+		int32 NumRegressions = 0;
+		for (const FBenchmarkResult& Result : Results)
+		{
+			const double* Expected = Baseline.NsPerCall.Find(Result.Name);
+			if (Expected == nullptr)
+			{
+				if (bRequireBaseline)
+				{
+					UE_LOG(LogDbgLogBenchmark, Error, TEXT("%s has no baseline, run with -updatebaseline to record one."), *Result.Name);
+					++NumRegressions;
+				}
+				else
+				{
+					UE_LOG(LogDbgLogBenchmark, Warning, TEXT("%s has no baseline, run with -updatebaseline to record one."), *Result.Name);
+				}
+				continue;
+			}
+
+			const double Limit = *Expected * (1.0 + Baseline.Tolerance);
+			if (Result.NsPerCall > Limit)
+			{
+				UE_LOG(LogDbgLogBenchmark, Error, TEXT("%s (%s) regressed, %.1f ns/call against a baseline of %.1f (limit %.1f)."),
+					*Result.Name, *Result.Implementation, Result.NsPerCall, *Expected, Limit);
+				++NumRegressions;
+			}
+		}
+		return NumRegressions;
+	}
+}
+
+
+int32 UDbgLogBenchmarkCommandlet::Main(const FString& Params)
+{
+	const bool bFormatters = FParse::Param(*Params, TEXT("formatters"));
+
+	int64 Iterations = 20000;
+	FParse::Value(*Params, TEXT("iterations="), Iterations);
+	Iterations = FMath::Max<int64>(Iterations, 1);
+
+	int32 Repetitions = 5;
+	FParse::Value(*Params, TEXT("repetitions="), Repetitions);
+	Repetitions = FMath::Clamp(Repetitions, 1, 16);
+
+	FString OutputPath = FPaths::ProjectSavedDir() / TEXT("Benchmarks") / (bFormatters ? TEXT("DbgLogFormatterBenchmark.json") : TEXT("DbgLogBenchmark.json"));
+	FParse::Value(*Params, TEXT("output="), OutputPath);
+
+	// Something for .WCO() and the UObject argument to point at.
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("DbgLogBenchmark"));
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	// Never uninstalled or freed, other threads may have picked up GMalloc already and keep calling into it. It only counts
+	// while a benchmark loop has switched counting on for its own thread, so leaving it in place costs a forwarded call.
+	FDbgLogCountingMalloc* const CountingMalloc = new FDbgLogCountingMalloc(GMalloc);
+	GMalloc = CountingMalloc;
+
+	FBenchmarkRunner Runner(*CountingMalloc, Iterations, Repetitions);
+	if (bFormatters)
+	{
+		RunFormatterBenchmarks(Runner, World);
+	}
+	else
+	{
+		RunLogBenchmarks(Runner, World);
+	}
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+
+	for (const FBenchmarkResult& Result : Runner.GetResults())
+	{
+		UE_LOG(LogDbgLogBenchmark, Display, TEXT("%-20s %-20s %2d threads %10.1f ns/call %8.2f allocs/call"),
+			*Result.Name, *Result.Implementation, Result.NumThreads, Result.NsPerCall, Result.AllocationsPerCall);
+	}
+
+	if (FFileHelper::SaveStringToFile(ResultsToJson(Runner.GetResults()), *OutputPath) == false)
+	{
+		UE_LOG(LogDbgLogBenchmark, Error, TEXT("Failed to write the results to %s."), *OutputPath);
+		return 1;
+	}
+
+	UE_LOG(LogDbgLogBenchmark, Display, TEXT("Results written to %s."), *OutputPath);
+
+	if (bFormatters == false)
+	{
+		return 0;
+	}
+
+	FString BaselinePath = GetDefaultBaselinePath();
+	FParse::Value(*Params, TEXT("baseline="), BaselinePath);
+
+	FFormatterBaseline Baseline;
+	const bool bHasBaseline = LoadBaseline(BaselinePath, Baseline);
+	FParse::Value(*Params, TEXT("tolerance="), Baseline.Tolerance);
+
+	if (FParse::Param(*Params, TEXT("updatebaseline")))
+	{
+		if (SaveBaseline(BaselinePath, Runner.GetResults(), Baseline.Tolerance) == false)
+		{
+			UE_LOG(LogDbgLogBenchmark, Error, TEXT("Failed to write the baseline to %s."), *BaselinePath);
+			return 1;
+		}
+
+		UE_LOG(LogDbgLogBenchmark, Display, TEXT("Baseline written to %s."), *BaselinePath);
+		return 0;
+	}
+
+	// Without it a missing or empty baseline can never fail the run, which is fine locally but not on the machine doing the check.
+	const bool bRequireBaseline = FParse::Param(*Params, TEXT("requirebaseline"));
+	if (bHasBaseline == false)
+	{
+		if (bRequireBaseline)
+		{
+			UE_LOG(LogDbgLogBenchmark, Error, TEXT("No baseline found at %s, run with -updatebaseline to record one."), *BaselinePath);
+			return 1;
+		}
+
+		UE_LOG(LogDbgLogBenchmark, Warning, TEXT("No baseline found at %s, run with -updatebaseline to record one."), *BaselinePath);
+		return 0;
+	}
+
+	const int32 NumRegressions = CheckBaseline(Baseline, Runner.GetResults(), bRequireBaseline);
+	if (NumRegressions > 0)
+	{
+		UE_LOG(LogDbgLogBenchmark, Error, TEXT("%d formatter case(s) regressed by more than %.0f%% or have no baseline."), NumRegressions, Baseline.Tolerance * 100.0);
+		return 1;
+	}
+
+	UE_LOG(LogDbgLogBenchmark, Display, TEXT("All formatter cases are within %.0f%% of the baseline."), Baseline.Tolerance * 100.0);
+	return 0;
+}
+
+#else
+
+int32 UDbgLogBenchmarkCommandlet::Main(const FString& Params)
+{
+	UE_LOG(LogDbgLogBenchmark, Error, TEXT("dbgLOG is compiled out (KEEP_DBG_LOG is 0), there is nothing to benchmark."));
+	return 1;
+}
+
+#endif
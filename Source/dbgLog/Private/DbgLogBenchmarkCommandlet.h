@@ -0,0 +1,52 @@
+// Copyright ©  Jack Holland.
+//
+// DbgLOG is free software. It comes without any warranty, to the extent permitted
+// by applicable law. You can redistribute it and/or modify it under the terms
+// of the Do What The Fuck You Want To Public License, Version 2, as published
+// by Sam Hocevar:
+//
+//            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+//                    Version 2, December 2004
+//
+// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+//
+// Everyone is permitted to copy and distribute verbatim or modified
+// copies of this license document, and changing it is allowed as long
+// as the name is changed.
+//
+//            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+//   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+//
+//  0. You just DO WHAT THE FUCK YOU WANT TO.
+#pragma once
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "DbgLogBenchmarkCommandlet.generated.h"
+
+
+/**
+ * Measures the dbgLOG hot paths (nanoseconds and allocations per call) next to UE_LOG and UE_LOGFMT doing the same work,
+ * and writes the results as JSON. Runs headless:
+ *
+ *	UnrealEditor-Cmd <Project>.uproject -run=DbgLogBenchmark -nullrhi -unattended [-iterations=20000] [-repetitions=5] [-output=<File.json>]
+ *
+ * Every case is run `-repetitions` times and the median one is reported. Logs that make it to the output devices pay for
+ * them like any other log, both for dbgLOG and the baselines. Running with `-NoLogConsole` keeps stdout out of the numbers.
+ *
+ * `-formatters` instead times FormatArgument on its own, one case per branch, and compares the result against
+ * `Config/DbgLogFormatterBaseline.ini` (or `-baseline=<File.ini>`). The commandlet returns 1 if any case got slower than
+ * the baseline's tolerance (`-tolerance=0.25` overrides it), or with `-requirebaseline` if the baseline or a case's entry
+ * is missing. `-updatebaseline` records the current numbers instead.
+ */
+UCLASS()
+class UDbgLogBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+public:
+	UDbgLogBenchmarkCommandlet();
+
+	//~ UCommandlet
+	virtual int32 Main(const FString& Params) override;
+	//~ UCommandlet
+};
@@ -0,0 +1,190 @@
+// Copyright ©  Jack Holland.
+//
+// DbgLOG is free software. It comes without any warranty, to the extent permitted
+// by applicable law. You can redistribute it and/or modify it under the terms
+// of the Do What The Fuck You Want To Public License, Version 2, as published
+// by Sam Hocevar:
+//
+//            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+//                    Version 2, December 2004
+//
+// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+//
+// Everyone is permitted to copy and distribute verbatim or modified
+// copies of this license document, and changing it is allowed as long
+// as the name is changed.
+//
+//            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+//   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+//
+//  0. You just DO WHAT THE FUCK YOU WANT TO.
+
+#include "DbgLogBinary.h"
+#include "dbgLog.h" // Relative path that must be updated if you move the files location.
+
+#include "HAL/FileManager.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+
+
+#if KEEP_DBG_LOG
+
+static bool GDbgLogBinaryEnabled = false;
+static FAutoConsoleVariableRef CVarDbgLogBinary
+	{
+		TEXT("dbgLog.Binary"),
+		GDbgLogBinaryEnabled,
+		TEXT("If true, console only dbgLOGs are written to a compact binary .dbglog file in the project log directory instead of the text log.\n")
+		TEXT("Use Tools/DbgLogDecoder to turn it back into text or JSON."),
+		FConsoleVariableDelegate::CreateLambda([](IConsoleVariable* Variable)
+		{
+			DBG::Log::GDbgLogBinarySink.SetEnabled(Variable->GetBool());
+		})
+	};
+
+
+
+namespace DBG::Log
+{
+	FDbgLogBinarySink GDbgLogBinarySink;
+
+	/**
+	 * File layout (little endian), everything after the header is a sequence of entries starting with their kind:
+	 *	Header:		"DBGL", uint32 Version, uint64 StartCycles, double SecondsPerCycle, int64 StartUtcTicks
+	 *	'C':		varint Id, varint Line, string File, string Format
+	 *	'K':		varint Id, string Category
+	 *	'L':		varint Id, varint CategoryId, zigzag varint CyclesDelta, uint8 Verbosity, string Prefix, uint8 NumArgs, NumArgs * (uint8 Tag, value)
+	 * Strings are a varint byte count followed by UTF-8.
+	 */
+	static constexpr uint8 CallsiteEntry = 'C';
+	static constexpr uint8 CategoryEntry = 'K';
+	static constexpr uint8 LogEntry = 'L';
+
+	FDbgLogBinarySink::FDbgLogBinarySink() = default;
+	FDbgLogBinarySink::~FDbgLogBinarySink() = default;
+
+	void FDbgLogBinarySink::StartupModule()
+	{
+		if (GDbgLogBinaryEnabled || FParse::Param(FCommandLine::Get(), TEXT("dbgLogBinary")))
+		{
+			SetEnabled(true);
+		}
+	}
+
+	void FDbgLogBinarySink::ShutdownModule()
+	{
+		SetEnabled(false);
+	}
+
+	void FDbgLogBinarySink::SetEnabled(bool bEnable)
+	{
+		FScopeLock ScopeLock(&Lock);
+		if (bEnable == Writer.IsValid())
+		{
+			return;
+		}
+
+		if (bEnable == false)
+		{
+			bEnabled.store(false, std::memory_order_relaxed);
+			Writer->Close();
+			Writer.Reset();
+			return;
+		}
+
+		const FString Filename = FPaths::ProjectLogDir() / FString::Printf(TEXT("%s_%s.dbglog"),
+			FApp::GetProjectName(), *FDateTime::Now().ToString());
+
+		Writer.Reset(IFileManager::Get().CreateFileWriter(*Filename, FILEWRITE_AllowRead));
+		if (Writer.IsValid() == false)
+		{
+			UE_LOG(dbgLOG, Warning, TEXT("Failed to open %s for binary logging, staying on the text log."), *Filename);
+			return;
+		}
+
+		++Generation;
+		NextCallsiteId = 0;
+		CategoryIds.Reset();
+		LastCycles = FPlatformTime::Cycles64();
+
+		uint8 Magic[4] = {'D', 'B', 'G', 'L'};
+		uint32 FileVersion = Version;
+		double SecondsPerCycle = FPlatformTime::GetSecondsPerCycle64();
+		int64 StartTicks = FDateTime::UtcNow().GetTicks();
+
+		Writer->Serialize(Magic, sizeof(Magic));
+		*Writer << FileVersion << LastCycles << SecondsPerCycle << StartTicks;
+
+		bEnabled.store(true, std::memory_order_relaxed);
+		UE_LOG(dbgLOG, Display, TEXT("Writing binary logs to %s"), *Filename);
+	}
+
+	void FDbgLogBinarySink::WriteRecord(std::atomic<uint64>& CallsiteId, const std::source_location& Location, uint64 Cycles,
+		std::wstring_view Format, const FLogCategoryBase& Category, ELogVerbosity::Type Verbosity, TConstArrayView<uint8> Arguments)
+	{
+		TArray<uint8, TInlineAllocator<64>> Header;
+
+		FScopeLock ScopeLock(&Lock);
+		if (Writer.IsValid() == false)
+		{
+			// Disabled between the caller checking and getting here, the log is lost either way.
+			return;
+		}
+
+		uint64 Id = CallsiteId.load(std::memory_order_relaxed);
+		if (static_cast<uint32>(Id >> 32) != Generation)
+		{
+			Id = (static_cast<uint64>(Generation) << 32) | NextCallsiteId++;
+			CallsiteId.store(Id, std::memory_order_relaxed);
+
+			TArray<uint8, TInlineAllocator<256>> Entry;
+			Entry.Add(CallsiteEntry);
+			WriteBinaryVarUInt(Entry, static_cast<uint32>(Id));
+			WriteBinaryVarUInt(Entry, Location.line());
+			WriteBinaryString(Entry, ANSI_TO_TCHAR(Location.file_name()));
+			WriteBinaryString(Entry, FStringView(Format.data(), static_cast<int32>(Format.size())));
+			Writer->Serialize(Entry.GetData(), Entry.Num());
+		}
+
+		uint32 CategoryId = 0;
+		if (const uint32* ExistingCategoryId = CategoryIds.Find(&Category))
+		{
+			CategoryId = *ExistingCategoryId;
+		}
+		else
+		{
+			CategoryId = CategoryIds.Num();
+			CategoryIds.Add(&Category, CategoryId);
+
+			TArray<uint8, TInlineAllocator<64>> Entry;
+			Entry.Add(CategoryEntry);
+			WriteBinaryVarUInt(Entry, CategoryId);
+			WriteBinaryString(Entry, Category.GetCategoryName().ToString());
+			Writer->Serialize(Entry.GetData(), Entry.Num());
+		}
+
+		// Stamped by the caller before taking the lock, so the delta can be negative when threads race.
+		Header.Add(LogEntry);
+		WriteBinaryVarUInt(Header, static_cast<uint32>(Id));
+		WriteBinaryVarUInt(Header, CategoryId);
+		WriteBinaryVarInt(Header, static_cast<int64>(Cycles - LastCycles));
+		Header.Add(static_cast<uint8>(Verbosity & ELogVerbosity::VerbosityMask));
+		LastCycles = Cycles;
+
+		Writer->Serialize(Header.GetData(), Header.Num());
+		Writer->Serialize(const_cast<uint8*>(Arguments.GetData()), Arguments.Num());
+	}
+
+	void FDbgLogBinarySink::Flush()
+	{
+		FScopeLock ScopeLock(&Lock);
+		if (Writer.IsValid())
+		{
+			Writer->Flush();
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,447 @@
+// Copyright ©  Jack Holland.
+//
+// DbgLOG is free software. It comes without any warranty, to the extent permitted
+// by applicable law. You can redistribute it and/or modify it under the terms
+// of the Do What The Fuck You Want To Public License, Version 2, as published
+// by Sam Hocevar:
+//
+//            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+//                    Version 2, December 2004
+//
+// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+//
+// Everyone is permitted to copy and distribute verbatim or modified
+// copies of this license document, and changing it is allowed as long
+// as the name is changed.
+//
+//            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+//   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+//
+//  0. You just DO WHAT THE FUCK YOU WANT TO.
+
+#include "DbgLogDebugDraw.h"
+#include "dbgLog.h" // Relative path that must be updated if you move the files location.
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/EngineVersionComparison.h"
+
+
+#if KEEP_DBG_LOG
+
+namespace DBG::Log
+{
+	FDbgLogDebugDrawBatcher GDbgLogDebugDraw;
+
+	void FDbgLogDebugDrawBatcher::StartupModule()
+	{
+		PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddLambda(
+			[this](UWorld* World, ELevelTick /*TickType*/, float /*DeltaSeconds*/)
+			{
+				Submit(World);
+			});
+
+		// Worlds that don't tick their actors (an editor world outside of PIE) never get the above, and anything drawn after
+		// the actors ticked would otherwise wait for the next frame's. Whatever is left goes out here so no batch outlives a frame.
+		EndFrameHandle = FCoreDelegates::OnEndFrame.AddLambda([this]()
+			{
+				for (const TPair<const UWorld*, FWorldBatch>& Pair : Batches)
+				{
+					Submit(Pair.Key);
+				}
+			});
+
+		WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddLambda(
+			[this](UWorld* World, bool /*bSessionEnded*/, bool /*bCleanupResources*/)
+			{
+				Batches.Remove(World);
+			});
+	}
+
+	void FDbgLogDebugDrawBatcher::ShutdownModule()
+	{
+		FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+		FWorldDelegates::OnWorldCleanup.Remove(WorldCleanupHandle);
+		FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+		PostActorTickHandle.Reset();
+		WorldCleanupHandle.Reset();
+		EndFrameHandle.Reset();
+		Batches.Empty();
+	}
+
+	void FDbgLogDebugDrawBatcher::AddLine(const UWorld* World, const FVector& Start, const FVector& End, const FColor& Color,
+		bool bPersistentLines, float LifeTime, uint8 DepthPriority, float Thickness)
+	{
+		const FTarget Target = GetTarget(World, bPersistentLines, LifeTime, DepthPriority);
+		if (Target.Lines)
+		{
+			Target.Lines->Emplace(Start, End, FLinearColor(Color), Target.LifeTime, Thickness, DepthPriority);
+		}
+	}
+
+	void FDbgLogDebugDrawBatcher::AddPoint(const UWorld* World, const FVector& Position, float Size, const FColor& Color,
+		bool bPersistentLines, float LifeTime, uint8 DepthPriority)
+	{
+		const FTarget Target = GetTarget(World, bPersistentLines, LifeTime, DepthPriority);
+		if (Target.Points)
+		{
+			Target.Points->Emplace(Position, Color.ReinterpretAsLinear(), Size, Target.LifeTime, DepthPriority);
+		}
+	}
+
+	void FDbgLogDebugDrawBatcher::AddDirectionalArrow(const UWorld* World, const FVector& Start, const FVector& End,
+		float ArrowSize, const FColor& Color, bool bPersistentLines, float LifeTime, uint8 DepthPriority, float Thickness)
+	{
+		const FTarget Target = GetTarget(World, bPersistentLines, LifeTime, DepthPriority);
+		if (Target.Lines == nullptr)
+		{
+			return;
+		}
+
+		FVector Dir = (End - Start);
+		Dir.Normalize();
+		FVector Up(0, 0, 1);
+		FVector Right = Dir ^ Up;
+		if (!Right.IsNormalized())
+		{
+			Dir.FindBestAxisVectors(Up, Right);
+		}
+
+		// The two heads point back along -Dir, one to each side.
+		const double ArrowSqrt = FMath::Sqrt(ArrowSize);
+		const FLinearColor LinearColor(Color);
+		TArray<FBatchedLine>& Lines = *Target.Lines;
+		Lines.Emplace(Start, End, LinearColor, Target.LifeTime, Thickness, DepthPriority);
+		Lines.Emplace(End, End + (Right - Dir) * ArrowSqrt, LinearColor, Target.LifeTime, Thickness, DepthPriority);
+		Lines.Emplace(End, End - (Right + Dir) * ArrowSqrt, LinearColor, Target.LifeTime, Thickness, DepthPriority);
+	}
+
+	void FDbgLogDebugDrawBatcher::AddBox(const UWorld* World, const FVector& Center, const FVector& Extent, const FColor& Color,
+		bool bPersistentLines, float LifeTime, uint8 DepthPriority, float Thickness)
+	{
+		const FTarget Target = GetTarget(World, bPersistentLines, LifeTime, DepthPriority);
+		if (Target.Lines == nullptr)
+		{
+			return;
+		}
+
+		// Corner i has the signs of bits 0 (X), 1 (Y) and 2 (Z), an edge connects corners that differ in exactly one bit.
+		FVector Corners[8];
+		for (int32 Index = 0; Index < 8; ++Index)
+		{
+			Corners[Index] = Center + FVector(Index & 1 ? Extent.X : -Extent.X, Index & 2 ? Extent.Y : -Extent.Y, Index & 4 ? Extent.Z : -Extent.Z);
+		}
+
+		static constexpr uint8 Edges[12][2] =
+		{
+			{0, 1}, {1, 3}, {3, 2}, {2, 0},
+			{4, 5}, {5, 7}, {7, 6}, {6, 4},
+			{0, 4}, {1, 5}, {2, 6}, {3, 7},
+		};
+
+		const FLinearColor LinearColor(Color);
+		TArray<FBatchedLine>& Lines = *Target.Lines;
+		Lines.Reserve(Lines.Num() + UE_ARRAY_COUNT(Edges));
+		for (const uint8 (&Edge)[2] : Edges)
+		{
+			Lines.Emplace(Corners[Edge[0]], Corners[Edge[1]], LinearColor, Target.LifeTime, Thickness, DepthPriority);
+		}
+	}
+
+	void FDbgLogDebugDrawBatcher::AddSphere(const UWorld* World, const FVector& Center, float Radius, int32 Segments,
+		const FColor& Color, bool bPersistentLines, float LifeTime, uint8 DepthPriority, float Thickness)
+	{
+		const FTarget Target = GetTarget(World, bPersistentLines, LifeTime, DepthPriority);
+		if (Target.Lines == nullptr)
+		{
+			return;
+		}
+
+		Segments = FMath::Max(Segments, 4);
+		const TConstArrayView<FVector2D> Circle = GetUnitCircle(Segments);
+
+		// The engine walks the latitudes all the way round, with an even amount of segments the second half only retraces the first.
+		const int32 NumLatitudes = Segments % 2 == 0 ? Segments / 2 : Segments;
+
+		const FLinearColor LinearColor(Color);
+		TArray<FBatchedLine>& Lines = *Target.Lines;
+		Lines.Reserve(Lines.Num() + NumLatitudes * Segments * 2);
+		for (int32 Latitude = 1; Latitude <= NumLatitudes; ++Latitude)
+		{
+			const FVector2D Y1 = Circle[Latitude - 1];
+			const FVector2D Y2 = Circle[Latitude];
+			FVector Vertex1 = FVector(Y1.Y, 0.0, Y1.X) * Radius + Center;
+			FVector Vertex3 = FVector(Y2.Y, 0.0, Y2.X) * Radius + Center;
+
+			for (int32 Longitude = 1; Longitude <= Segments; ++Longitude)
+			{
+				const FVector2D X = Circle[Longitude];
+				const FVector Vertex2 = FVector(X.X * Y1.Y, X.Y * Y1.Y, Y1.X) * Radius + Center;
+				const FVector Vertex4 = FVector(X.X * Y2.Y, X.Y * Y2.Y, Y2.X) * Radius + Center;
+
+				Lines.Emplace(Vertex1, Vertex2, LinearColor, Target.LifeTime, Thickness, DepthPriority);
+				Lines.Emplace(Vertex1, Vertex3, LinearColor, Target.LifeTime, Thickness, DepthPriority);
+				Vertex1 = Vertex2;
+				Vertex3 = Vertex4;
+			}
+		}
+	}
+
+	void FDbgLogDebugDrawBatcher::AddCylinder(const UWorld* World, const FVector& Start, const FVector& End, float Radius,
+		int32 Segments, const FColor& Color, bool bPersistentLines, float LifeTime, uint8 DepthPriority, float Thickness)
+	{
+		const FTarget Target = GetTarget(World, bPersistentLines, LifeTime, DepthPriority);
+		if (Target.Lines == nullptr)
+		{
+			return;
+		}
+
+		Segments = FMath::Max(Segments, 4);
+		const TConstArrayView<FVector2D> Circle = GetUnitCircle(Segments);
+
+		FVector Axis = (End - Start).GetSafeNormal();
+		if (Axis.IsZero())
+		{
+			Axis = FVector(0.0, 0.0, 1.0);
+		}
+
+		// Rotating the perpendicular around the axis is just a mix of it and the bitangent.
+		FVector Perpendicular, Dummy;
+		Axis.FindBestAxisVectors(Perpendicular, Dummy);
+		const FVector Bitangent = Axis ^ Perpendicular;
+
+		const FLinearColor LinearColor(Color);
+		TArray<FBatchedLine>& Lines = *Target.Lines;
+		Lines.Reserve(Lines.Num() + Segments * 3);
+
+		FVector P1 = Perpendicular * Radius + Start;
+		FVector P3 = Perpendicular * Radius + End;
+		for (int32 Segment = 1; Segment <= Segments; ++Segment)
+		{
+			const FVector Offset = (Perpendicular * Circle[Segment].X + Bitangent * Circle[Segment].Y) * Radius;
+			const FVector P2 = Offset + Start;
+			const FVector P4 = Offset + End;
+
+			Lines.Emplace(P2, P4, LinearColor, Target.LifeTime, Thickness, DepthPriority);
+			Lines.Emplace(P1, P2, LinearColor, Target.LifeTime, Thickness, DepthPriority);
+			Lines.Emplace(P3, P4, LinearColor, Target.LifeTime, Thickness, DepthPriority);
+			P1 = P2;
+			P3 = P4;
+		}
+	}
+
+	void FDbgLogDebugDrawBatcher::AddCone(const UWorld* World, const FVector& Origin, const FVector& Direction, float Length,
+		float AngleWidth, float AngleHeight, int32 NumSides, const FColor& Color, bool bPersistentLines, float LifeTime,
+		uint8 DepthPriority, float Thickness)
+	{
+		const FTarget Target = GetTarget(World, bPersistentLines, LifeTime, DepthPriority);
+		if (Target.Lines == nullptr)
+		{
+			return;
+		}
+
+		NumSides = FMath::Max(NumSides, 4);
+		const TConstArrayView<FVector2D> Circle = GetUnitCircle(NumSides);
+
+		const double Angle1 = FMath::Clamp<double>(AngleHeight, UE_KINDA_SMALL_NUMBER, UE_PI - UE_KINDA_SMALL_NUMBER);
+		const double Angle2 = FMath::Clamp<double>(AngleWidth, UE_KINDA_SMALL_NUMBER, UE_PI - UE_KINDA_SMALL_NUMBER);
+		const double SinX_2 = FMath::Sin(0.5 * Angle1);
+		const double SinY_2 = FMath::Sin(0.5 * Angle2);
+		const double SinSqX_2 = SinX_2 * SinX_2;
+		const double SinSqY_2 = SinY_2 * SinY_2;
+
+		FVector YAxis, ZAxis;
+		const FVector DirectionNorm = Direction.GetSafeNormal();
+		DirectionNorm.FindBestAxisVectors(YAxis, ZAxis);
+
+		const FLinearColor LinearColor(Color);
+		TArray<FBatchedLine>& Lines = *Target.Lines;
+		Lines.Reserve(Lines.Num() + NumSides * 2);
+
+		FVector FirstPoint, PrevPoint;
+		for (int32 Side = 0; Side < NumSides; ++Side)
+		{
+			// Same elliptical cone as the engine's DrawDebugCone, the angle it takes the atan2 of is only needed as a sin/cos pair.
+			const double A = Circle[Side].X * SinX_2;
+			const double B = Circle[Side].Y * SinY_2;
+			const double InvLength = FMath::InvSqrt(A * A + B * B);
+			const double CosPhi = A * InvLength;
+			const double SinPhi = B * InvLength;
+
+			const double RSq = SinSqX_2 * SinSqY_2 / (SinSqX_2 * SinPhi * SinPhi + SinSqY_2 * CosPhi * CosPhi);
+			const double R = FMath::Sqrt(RSq);
+			const double Sqr = FMath::Sqrt(1.0 - RSq);
+
+			const FVector Point = Origin + (DirectionNorm * (1.0 - 2.0 * RSq) + YAxis * (2.0 * Sqr * R * CosPhi) + ZAxis * (2.0 * Sqr * R * SinPhi)) * Length;
+			Lines.Emplace(Origin, Point, LinearColor, Target.LifeTime, Thickness, DepthPriority);
+
+			if (Side > 0)
+			{
+				Lines.Emplace(PrevPoint, Point, LinearColor, Target.LifeTime, Thickness, DepthPriority);
+			}
+			else
+			{
+				FirstPoint = Point;
+			}
+			PrevPoint = Point;
+		}
+		Lines.Emplace(PrevPoint, FirstPoint, LinearColor, Target.LifeTime, Thickness, DepthPriority);
+	}
+
+	void FDbgLogDebugDrawBatcher::AddCapsule(const UWorld* World, const FVector& Center, float HalfHeight, float Radius,
+		const FQuat& Rotation, const FColor& Color, bool bPersistentLines, float LifeTime, uint8 DepthPriority, float Thickness)
+	{
+		const FTarget Target = GetTarget(World, bPersistentLines, LifeTime, DepthPriority);
+		if (Target.Lines == nullptr)
+		{
+			return;
+		}
+
+		static constexpr int32 DrawCollisionSides = 16;
+		const FVector XAxis = Rotation.GetAxisX();
+		const FVector YAxis = Rotation.GetAxisY();
+		const FVector ZAxis = Rotation.GetAxisZ();
+
+		const double HalfAxis = FMath::Max<double>(HalfHeight - Radius, 1.0);
+		const FVector TopEnd = Center + HalfAxis * ZAxis;
+		const FVector BottomEnd = Center - HalfAxis * ZAxis;
+		const FLinearColor LinearColor(Color);
+
+		Target.Lines->Reserve(Target.Lines->Num() + DrawCollisionSides * 4 + 4);
+
+		// Top and bottom rings, then the domed caps.
+		AddCircle(Target, TopEnd, XAxis, YAxis, LinearColor, Radius, DrawCollisionSides, DrawCollisionSides, DepthPriority, Thickness);
+		AddCircle(Target, BottomEnd, XAxis, YAxis, LinearColor, Radius, DrawCollisionSides, DrawCollisionSides, DepthPriority, Thickness);
+		AddCircle(Target, TopEnd, YAxis, ZAxis, LinearColor, Radius, DrawCollisionSides, DrawCollisionSides / 2, DepthPriority, Thickness);
+		AddCircle(Target, TopEnd, XAxis, ZAxis, LinearColor, Radius, DrawCollisionSides, DrawCollisionSides / 2, DepthPriority, Thickness);
+		AddCircle(Target, BottomEnd, YAxis, -ZAxis, LinearColor, Radius, DrawCollisionSides, DrawCollisionSides / 2, DepthPriority, Thickness);
+		AddCircle(Target, BottomEnd, XAxis, -ZAxis, LinearColor, Radius, DrawCollisionSides, DrawCollisionSides / 2, DepthPriority, Thickness);
+
+		// And the lines connecting them.
+		TArray<FBatchedLine>& Lines = *Target.Lines;
+		Lines.Emplace(TopEnd + Radius * XAxis, BottomEnd + Radius * XAxis, LinearColor, Target.LifeTime, Thickness, DepthPriority);
+		Lines.Emplace(TopEnd - Radius * XAxis, BottomEnd - Radius * XAxis, LinearColor, Target.LifeTime, Thickness, DepthPriority);
+		Lines.Emplace(TopEnd + Radius * YAxis, BottomEnd + Radius * YAxis, LinearColor, Target.LifeTime, Thickness, DepthPriority);
+		Lines.Emplace(TopEnd - Radius * YAxis, BottomEnd - Radius * YAxis, LinearColor, Target.LifeTime, Thickness, DepthPriority);
+	}
+
+	FDbgLogDebugDrawBatcher::FTarget FDbgLogDebugDrawBatcher::GetTarget(const UWorld* World, bool bPersistentLines,
+		float LifeTime, uint8 DepthPriority)
+	{
+		check(IsInGameThread());
+
+		FTarget Target;
+#if ENABLE_DRAW_DEBUG
+		if (World == nullptr || GEngine->GetNetMode(World) == NM_DedicatedServer)
+		{
+			return Target;
+		}
+
+		// This means foreground lines can't be persistent, same as with the engine.
+		const EBatcher Batcher = DepthPriority == SDPG_Foreground
+			? ForegroundBatcher
+			: (bPersistentLines || LifeTime > 0.f) ? PersistentBatcher : WorldBatcher;
+
+		const ULineBatchComponent* LineBatcher = GetLineBatcher(World, Batcher);
+		if (LineBatcher == nullptr)
+		{
+			return Target;
+		}
+
+		FWorldBatch& Batch = Batches.FindOrAdd(World);
+		Target.Lines = &Batch.Lines[Batcher];
+		Target.Points = &Batch.Points[Batcher];
+		Target.LifeTime = bPersistentLines ? -1.f : (LifeTime > 0.f ? LifeTime : LineBatcher->DefaultLifeTime);
+#endif
+		return Target;
+	}
+
+	ULineBatchComponent* FDbgLogDebugDrawBatcher::GetLineBatcher(const UWorld* World, EBatcher Batcher)
+	{
+#if UE_VERSION_OLDER_THAN(5, 5, 0)
+		switch (Batcher)
+		{
+			case WorldBatcher:			return World->LineBatcher;
+			case PersistentBatcher:		return World->PersistentLineBatcher;
+			default:					return World->ForegroundLineBatcher;
+		}
+#else
+		switch (Batcher)
+		{
+			case WorldBatcher:			return World->GetLineBatcher(UWorld::ELineBatcherType::World);
+			case PersistentBatcher:		return World->GetLineBatcher(UWorld::ELineBatcherType::WorldPersistent);
+			default:					return World->GetLineBatcher(UWorld::ELineBatcherType::Foreground);
+		}
+#endif
+	}
+
+	TConstArrayView<FVector2D> FDbgLogDebugDrawBatcher::GetUnitCircle(int32 NumSides)
+	{
+		if (UnitCircleSides != NumSides)
+		{
+			UnitCircleSides = NumSides;
+			UnitCircle.SetNumUninitialized(NumSides + 1);
+
+			const double AngleDelta = 2.0 * UE_DOUBLE_PI / NumSides;
+			for (int32 Side = 0; Side <= NumSides; ++Side)
+			{
+				FMath::SinCos(&UnitCircle[Side].Y, &UnitCircle[Side].X, AngleDelta * Side);
+			}
+		}
+		return UnitCircle;
+	}
+
+	void FDbgLogDebugDrawBatcher::AddCircle(const FTarget& Target, const FVector& Base, const FVector& X, const FVector& Y,
+		const FLinearColor& Color, double Radius, int32 NumSides, int32 SidesToDraw, uint8 DepthPriority, float Thickness)
+	{
+		const TConstArrayView<FVector2D> Circle = GetUnitCircle(NumSides);
+
+		FVector LastVertex = Base + X * Radius;
+		for (int32 Side = 1; Side <= SidesToDraw; ++Side)
+		{
+			const FVector Vertex = Base + (X * Circle[Side].X + Y * Circle[Side].Y) * Radius;
+			Target.Lines->Emplace(LastVertex, Vertex, Color, Target.LifeTime, Thickness, DepthPriority);
+			LastVertex = Vertex;
+		}
+	}
+
+	void FDbgLogDebugDrawBatcher::Submit(const UWorld* World)
+	{
+		DBGLOG_TRACE_SCOPE(DebugDrawSubmit);
+		FWorldBatch* Batch = Batches.Find(World);
+		if (Batch == nullptr)
+		{
+			return;
+		}
+
+		for (int32 Index = 0; Index < NumBatchers; ++Index)
+		{
+			TArray<FBatchedLine>& Lines = Batch->Lines[Index];
+			TArray<FBatchedPoint>& Points = Batch->Points[Index];
+			if (Lines.Num() == 0 && Points.Num() == 0)
+			{
+				continue;
+			}
+
+			if (ULineBatchComponent* LineBatcher = GetLineBatcher(World, static_cast<EBatcher>(Index)))
+			{
+				if (Lines.Num() > 0)
+				{
+					LineBatcher->DrawLines(Lines);
+				}
+
+				for (const FBatchedPoint& Point : Points)
+				{
+					LineBatcher->DrawPoint(Point.Position, Point.Color, Point.PointSize, Point.DepthPriority, Point.RemainingLifeTime);
+				}
+			}
+
+			// Keep the memory around for next frame.
+			Lines.Reset();
+			Points.Reset();
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,60 @@
+// Copyright ©  Jack Holland.
+//
+// DbgLOG is free software. It comes without any warranty, to the extent permitted
+// by applicable law. You can redistribute it and/or modify it under the terms
+// of the Do What The Fuck You Want To Public License, Version 2, as published
+// by Sam Hocevar:
+//
+//            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+//                    Version 2, December 2004
+//
+// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+//
+// Everyone is permitted to copy and distribute verbatim or modified
+// copies of this license document, and changing it is allowed as long
+// as the name is changed.
+//
+//            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+//   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+//
+//  0. You just DO WHAT THE FUCK YOU WANT TO.
+
+#include "DbgLogGameThread.h"
+#include "dbgLog.h" // Relative path that must be updated if you move the files location.
+
+#include "Misc/CoreDelegates.h"
+
+
+#if KEEP_DBG_LOG
+
+namespace DBG::Log
+{
+	FDbgLogGameThreadDispatcher GDbgLogGameThread;
+
+	void FDbgLogGameThreadDispatcher::StartupModule()
+	{
+		EndFrameHandle = FCoreDelegates::OnEndFrame.AddRaw(this, &FDbgLogGameThreadDispatcher::Dispatch);
+	}
+
+	void FDbgLogGameThreadDispatcher::ShutdownModule()
+	{
+		FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+		EndFrameHandle.Reset();
+
+		// Whatever is left still deserves to be seen.
+		Dispatch();
+	}
+
+	void FDbgLogGameThreadDispatcher::Dispatch()
+	{
+		check(IsInGameThread());
+
+		TUniqueFunction<void()> Func;
+		while (Queue.Dequeue(Func))
+		{
+			Func();
+		}
+	}
+}
+
+#endif
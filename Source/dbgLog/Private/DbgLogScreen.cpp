@@ -0,0 +1,162 @@
+// Copyright ©  Jack Holland.
+//
+// DbgLOG is free software. It comes without any warranty, to the extent permitted
+// by applicable law. You can redistribute it and/or modify it under the terms
+// of the Do What The Fuck You Want To Public License, Version 2, as published
+// by Sam Hocevar:
+//
+//            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+//                    Version 2, December 2004
+//
+// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+//
+// Everyone is permitted to copy and distribute verbatim or modified
+// copies of this license document, and changing it is allowed as long
+// as the name is changed.
+//
+//            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+//   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+//
+//  0. You just DO WHAT THE FUCK YOU WANT TO.
+
+#include "DbgLogScreen.h"
+#include "dbgLog.h" // Relative path that must be updated if you move the files location.
+
+#include "Debug/DebugDrawService.h"
+#include "Engine/Canvas.h"
+#include "Engine/Engine.h"
+
+
+#if KEEP_DBG_LOG
+
+FAutoConsoleCommand ClearScreenMessagesCommand
+	{
+		TEXT("dbgLog.ClearScreenMessages"),
+		TEXT("Removes every dbgLOG message currently on screen."),
+		FConsoleCommandDelegate::CreateLambda([]()
+		{
+			DBG::Log::GDbgLogScreenMessages.Clear();
+		}),
+		ECVF_Cheat
+	};
+
+
+
+namespace DBG::Log
+{
+	FDbgLogScreenMessages GDbgLogScreenMessages;
+
+	void FDbgLogScreenMessages::StartupModule()
+	{
+		DrawHandle = UDebugDrawService::Register(TEXT("Game"), FDebugDrawDelegate::CreateRaw(this, &FDbgLogScreenMessages::Draw));
+	}
+
+	void FDbgLogScreenMessages::ShutdownModule()
+	{
+		UDebugDrawService::Unregister(DrawHandle);
+		DrawHandle.Reset();
+		Clear();
+	}
+
+	void FDbgLogScreenMessages::AddOrUpdate(uint64 Key, float Duration, FColor Color, const TCHAR* Message)
+	{
+		DBGLOG_TRACE_SCOPE(Screen);
+		const double Now = FPlatformTime::Seconds();
+
+		FScopeLock ScopeLock(&Lock);
+
+		FEntry* Target = nullptr;
+		for (FEntry& Entry : Entries)
+		{
+			if (Entry.Key == Key)
+			{
+				Target = &Entry;
+				break;
+			}
+
+			// Free or expired entries count as expiring the soonest.
+			const double ExpireTime = Entry.Key == 0 ? -1.0 : Entry.ExpireTime;
+			if (Target == nullptr || ExpireTime < (Target->Key == 0 ? -1.0 : Target->ExpireTime))
+			{
+				Target = &Entry;
+			}
+		}
+
+		if (Target->Key != Key)
+		{
+			Target->Key = Key;
+			Target->Sequence = ++NextSequence;
+		}
+		Target->ExpireTime = Now + Duration;
+		Target->Color = Color;
+
+		// Reset keeps the allocation around, so a message updated every frame stops allocating once it has grown.
+		Target->Text.Reset();
+		Target->Text += Message;
+	}
+
+	void FDbgLogScreenMessages::Clear()
+	{
+		FScopeLock ScopeLock(&Lock);
+		for (FEntry& Entry : Entries)
+		{
+			Entry.Key = 0;
+			Entry.Text.Empty();
+		}
+	}
+
+	void FDbgLogScreenMessages::Draw(UCanvas* Canvas, APlayerController* PlayerController)
+	{
+		if (Canvas == nullptr || GEngine == nullptr || GAreScreenMessagesEnabled == false)
+		{
+			return;
+		}
+
+		const double Now = FPlatformTime::Seconds();
+		UFont* Font = GEngine->GetSmallFont();
+		const FFontRenderInfo RenderInfo = Canvas->CreateFontRenderInfo(false, true);
+
+		// Where the engine draws its own on-screen messages (AddOnScreenDebugMessage, PrintString), skipping past the ones
+		// it has right now so the two lists don't overlap.
+		const float X = Canvas->ClipX * 0.05f;
+		float Y = Canvas->ClipY * 0.15f;
+		const float LineHeight = Font->GetMaxCharHeight();
+		for (const FScreenMessageString& EngineMessage : GEngine->PriorityScreenMessages)
+		{
+			Y += LineHeight * EngineMessage.TextScale.Y;
+		}
+		for (const auto& EngineMessage : GEngine->ScreenMessages)
+		{
+			Y += LineHeight * EngineMessage.Value.TextScale.Y;
+		}
+
+		FScopeLock ScopeLock(&Lock);
+
+		TArray<FEntry*, TInlineAllocator<Capacity>> Live;
+		for (FEntry& Entry : Entries)
+		{
+			if (Entry.Key == 0)
+			{
+				continue;
+			}
+
+			if (Entry.ExpireTime < Now)
+			{
+				Entry.Key = 0;
+				continue;
+			}
+
+			Live.Add(&Entry);
+		}
+
+		// Newest on top, the same as the engine's list.
+		Live.Sort([](const FEntry& A, const FEntry& B) { return A.Sequence > B.Sequence; });
+		for (const FEntry* Entry : Live)
+		{
+			Canvas->SetDrawColor(Entry->Color);
+			Y += Canvas->DrawText(Font, Entry->Text, X, Y, 1.f, 1.f, RenderInfo);
+		}
+	}
+}
+
+#endif
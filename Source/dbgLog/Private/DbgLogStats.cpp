@@ -0,0 +1,286 @@
+// Copyright ©  Jack Holland.
+//
+// DbgLOG is free software. It comes without any warranty, to the extent permitted
+// by applicable law. You can redistribute it and/or modify it under the terms
+// of the Do What The Fuck You Want To Public License, Version 2, as published
+// by Sam Hocevar:
+//
+//            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+//                    Version 2, December 2004
+//
+// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+//
+// Everyone is permitted to copy and distribute verbatim or modified
+// copies of this license document, and changing it is allowed as long
+// as the name is changed.
+//
+//            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+//   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+//
+//  0. You just DO WHAT THE FUCK YOU WANT TO.
+
+#include "DbgLogStats.h"
+#include "dbgLog.h" // Relative path that must be updated if you move the files location.
+
+#include "Misc/CommandLine.h"
+
+
+#if KEEP_DBG_LOG
+
+static bool GDbgLogStatsCollect = false;
+static FAutoConsoleVariableRef CVarDbgLogStatsCollect
+	{
+		TEXT("dbgLog.Stats.Collect"),
+		GDbgLogStatsCollect,
+		TEXT("If true, dbgLOG counts how often every callsite fires or gets suppressed and how long it spends formatting and emitting, see `dbgLog.Stats`."),
+		FConsoleVariableDelegate::CreateLambda([](IConsoleVariable* Variable)
+		{
+			DBG::Log::GDbgLogStats.SetCollecting(Variable->GetBool());
+		})
+	};
+
+
+
+namespace DBG::Log
+{
+	FDbgLogStats GDbgLogStats;
+
+	/**
+	 * Open addressing table keyed by the callsite address. Only the owning thread inserts and counts, so every counter is a
+	 * plain relaxed load and store, and a slot's key is published last so readers never see a half made entry.
+	 */
+	struct FDbgLogStats::FThreadTable
+	{
+		static constexpr uint32 NumSlots = 1024;
+
+		struct FSlot
+		{
+			std::atomic<const FDbgLogCallsite*> Callsite{nullptr};
+
+			// Copied before the key is published and never written again, the callsite itself could be unloaded by the time anyone reads them.
+			FString File;
+			uint32 Line = 0;
+
+			// Category handles live until shutdown, unlike the category they point at.
+			std::atomic<const FDbgLogCategoryHandle*> Category{nullptr};
+
+			std::atomic<uint64> Fired{0};
+			std::atomic<uint64> Suppressed{0};
+			std::atomic<uint64> FormatCycles{0};
+			std::atomic<uint64> EmitCycles{0};
+		};
+
+		FSlot Slots[NumSlots];
+		std::atomic<uint64> Overflowed{0};
+
+		static void Add(std::atomic<uint64>& Counter, uint64 Value)
+		{
+			Counter.store(Counter.load(std::memory_order_relaxed) + Value, std::memory_order_relaxed);
+		}
+
+		// Null once every slot is taken.
+		FSlot* FindOrAdd(const FDbgLogCallsite& Callsite)
+		{
+			uint32 Index = static_cast<uint32>(Callsite.Hash) & (NumSlots - 1);
+			for (uint32 Probe = 0; Probe < NumSlots; ++Probe, Index = (Index + 1) & (NumSlots - 1))
+			{
+				FSlot& Slot = Slots[Index];
+				const FDbgLogCallsite* Existing = Slot.Callsite.load(std::memory_order_relaxed);
+				if (Existing == &Callsite)
+				{
+					UpdateCategory(Slot, Callsite);
+					return &Slot;
+				}
+
+				if (Existing == nullptr)
+				{
+					TStringBuilder<128> File;
+					File.Append(Callsite.CleanFileName.data(), static_cast<int32>(Callsite.CleanFileName.size()));
+					Slot.File = File.ToString();
+					Slot.Line = Callsite.Location.line();
+					UpdateCategory(Slot, Callsite);
+					Slot.Callsite.store(&Callsite, std::memory_order_release);
+					return &Slot;
+				}
+			}
+
+			Add(Overflowed, 1);
+			return nullptr;
+		}
+
+		static void UpdateCategory(FSlot& Slot, const FDbgLogCallsite& Callsite)
+		{
+			const FDbgLogCategoryHandle* Handle = Callsite.CachedCategory.load(std::memory_order_acquire);
+			if (Handle != Slot.Category.load(std::memory_order_relaxed))
+			{
+				Slot.Category.store(Handle, std::memory_order_release);
+			}
+		}
+
+		// Adds every published slot to Totals.
+		void AddTo(TMap<const FDbgLogCallsite*, FCallsiteStats>& Totals) const
+		{
+			for (const FSlot& Slot : Slots)
+			{
+				const FDbgLogCallsite* Callsite = Slot.Callsite.load(std::memory_order_acquire);
+				if (Callsite == nullptr)
+				{
+					continue;
+				}
+
+				FCallsiteStats& Stats = Totals.FindOrAdd(Callsite);
+				if (Stats.File.IsEmpty())
+				{
+					Stats.File = Slot.File;
+					Stats.Line = Slot.Line;
+				}
+				if (const FDbgLogCategoryHandle* Handle = Slot.Category.load(std::memory_order_acquire))
+				{
+					Stats.Category = Handle->Name;
+				}
+				Stats.Fired += Slot.Fired.load(std::memory_order_relaxed);
+				Stats.Suppressed += Slot.Suppressed.load(std::memory_order_relaxed);
+				Stats.FormatCycles += Slot.FormatCycles.load(std::memory_order_relaxed);
+				Stats.EmitCycles += Slot.EmitCycles.load(std::memory_order_relaxed);
+			}
+		}
+	};
+
+	// Hands the thread's table back when the thread exits, so threads that come and go don't leave their tables behind.
+	struct FDbgLogStats::FThreadTableOwner
+	{
+		FDbgLogStats* Stats = nullptr;
+		FThreadTable* Table = nullptr;
+
+		~FThreadTableOwner()
+		{
+			if (Table)
+			{
+				Stats->RetireThreadTable(Table);
+			}
+		}
+	};
+
+	FDbgLogStats::FDbgLogStats() = default;
+	FDbgLogStats::~FDbgLogStats() = default;
+
+	void FDbgLogStats::StartupModule()
+	{
+		if (GDbgLogStatsCollect || FParse::Param(FCommandLine::Get(), TEXT("dbgLogStats")))
+		{
+			SetCollecting(true);
+		}
+	}
+
+	void FDbgLogStats::ShutdownModule()
+	{
+		// The tables stay around, threads that are still running keep pointing at theirs until they exit.
+		SetCollecting(false);
+	}
+
+	FDbgLogStats::FThreadTable& FDbgLogStats::GetThreadTable()
+	{
+		thread_local FThreadTableOwner Owner;
+		if (Owner.Table == nullptr)
+		{
+			TUniquePtr<FThreadTable> NewTable = MakeUnique<FThreadTable>();
+			Owner.Stats = this;
+			Owner.Table = NewTable.Get();
+
+			FScopeLock ScopeLock(&Lock);
+			ThreadTables.Add(MoveTemp(NewTable));
+		}
+		return *Owner.Table;
+	}
+
+	void FDbgLogStats::RetireThreadTable(FThreadTable* Table)
+	{
+		FScopeLock ScopeLock(&Lock);
+		Table->AddTo(RetiredTotals);
+		RetiredOverflowed += Table->Overflowed.load(std::memory_order_relaxed);
+		ThreadTables.RemoveAllSwap([Table](const TUniquePtr<FThreadTable>& Existing) { return Existing.Get() == Table; });
+	}
+
+	void FDbgLogStats::AddSuppressed(const FDbgLogCallsite& Callsite)
+	{
+		if (FThreadTable::FSlot* Slot = GetThreadTable().FindOrAdd(Callsite))
+		{
+			FThreadTable::Add(Slot->Suppressed, 1);
+		}
+	}
+
+	void FDbgLogStats::AddFired(const FDbgLogCallsite& Callsite, uint64 FormatCycles, uint64 EmitCycles)
+	{
+		if (FThreadTable::FSlot* Slot = GetThreadTable().FindOrAdd(Callsite))
+		{
+			FThreadTable::Add(Slot->Fired, 1);
+			FThreadTable::Add(Slot->FormatCycles, FormatCycles);
+			FThreadTable::Add(Slot->EmitCycles, EmitCycles);
+		}
+	}
+
+	TMap<const FDbgLogCallsite*, FDbgLogStats::FCallsiteStats> FDbgLogStats::Sum() const
+	{
+		TMap<const FDbgLogCallsite*, FCallsiteStats> Totals = RetiredTotals;
+		for (const TUniquePtr<FThreadTable>& Table : ThreadTables)
+		{
+			Table->AddTo(Totals);
+		}
+		return Totals;
+	}
+
+	TArray<FDbgLogStats::FCallsiteStats> FDbgLogStats::Gather() const
+	{
+		FScopeLock ScopeLock(&Lock);
+
+		TArray<FCallsiteStats> Result;
+		for (const TPair<const FDbgLogCallsite*, FCallsiteStats>& Pair : Sum())
+		{
+			FCallsiteStats Stats = Pair.Value;
+			if (const FCallsiteStats* Baseline = ResetBaseline.Find(Pair.Key))
+			{
+				Stats.Fired -= Baseline->Fired;
+				Stats.Suppressed -= Baseline->Suppressed;
+				Stats.FormatCycles -= Baseline->FormatCycles;
+				Stats.EmitCycles -= Baseline->EmitCycles;
+			}
+
+			if (Stats.Fired > 0 || Stats.Suppressed > 0)
+			{
+				Result.Add(Stats);
+			}
+		}
+
+		Result.Sort([](const FCallsiteStats& A, const FCallsiteStats& B)
+		{
+			return A.GetTotalCycles() != B.GetTotalCycles() ? A.GetTotalCycles() > B.GetTotalCycles() : A.Suppressed > B.Suppressed;
+		});
+		return Result;
+	}
+
+	void FDbgLogStats::Reset()
+	{
+		FScopeLock ScopeLock(&Lock);
+		ResetBaseline = Sum();
+
+		ResetOverflowed = RetiredOverflowed;
+		for (const TUniquePtr<FThreadTable>& Table : ThreadTables)
+		{
+			ResetOverflowed += Table->Overflowed.load(std::memory_order_relaxed);
+		}
+	}
+
+	uint64 FDbgLogStats::GetNumOverflowed() const
+	{
+		FScopeLock ScopeLock(&Lock);
+
+		uint64 Overflowed = RetiredOverflowed;
+		for (const TUniquePtr<FThreadTable>& Table : ThreadTables)
+		{
+			Overflowed += Table->Overflowed.load(std::memory_order_relaxed);
+		}
+		return Overflowed - ResetOverflowed;
+	}
+}
+
+#endif
@@ -0,0 +1,124 @@
+// Copyright ©  Jack Holland.
+//
+// DbgLOG is free software. It comes without any warranty, to the extent permitted
+// by applicable law. You can redistribute it and/or modify it under the terms
+// of the Do What The Fuck You Want To Public License, Version 2, as published
+// by Sam Hocevar:
+//
+//            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+//                    Version 2, December 2004
+//
+// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+//
+// Everyone is permitted to copy and distribute verbatim or modified
+// copies of this license document, and changing it is allowed as long
+// as the name is changed.
+//
+//            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+//   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+//
+//  0. You just DO WHAT THE FUCK YOU WANT TO.
+
+#include "DbgLogTrace.h"
+#include "dbgLog.h" // Relative path that must be updated if you move the files location.
+
+#include "Misc/CoreDelegates.h"
+#include "ProfilingDebugging/CountersTrace.h"
+
+
+#if KEEP_DBG_LOG
+
+#if DBGLOG_TRACE_ENABLED
+UE_TRACE_CHANNEL_DEFINE(dbgLogChannel);
+
+// Sent once per callsite, Important so late connections still get to resolve the ids.
+UE_TRACE_EVENT_BEGIN(dbgLog, Callsite, NoSync|Important)
+	UE_TRACE_EVENT_FIELD(uint64, CallsiteId)
+	UE_TRACE_EVENT_FIELD(uint32, Line)
+	UE_TRACE_EVENT_FIELD(UE::Trace::AnsiString, File)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, Category)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(dbgLog, Log)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint64, CallsiteId)
+	UE_TRACE_EVENT_FIELD(uint8, Verbosity)
+UE_TRACE_EVENT_END()
+#endif
+
+TRACE_DECLARE_INT_COUNTER(DbgLogLogsPerSecond, TEXT("dbgLog/Logs per second"));
+TRACE_DECLARE_MEMORY_COUNTER(DbgLogFormattedBytes, TEXT("dbgLog/Formatted bytes"));
+TRACE_DECLARE_INT_COUNTER(DbgLogSuppressed, TEXT("dbgLog/Suppressed"));
+TRACE_DECLARE_INT_COUNTER(DbgLogDropped, TEXT("dbgLog/Dropped"));
+
+
+
+namespace DBG::Log
+{
+	FDbgLogTrace GDbgLogTrace;
+
+	void FDbgLogTrace::StartupModule()
+	{
+		EndFrameHandle = FCoreDelegates::OnEndFrame.AddRaw(this, &FDbgLogTrace::PublishCounters);
+	}
+
+	void FDbgLogTrace::ShutdownModule()
+	{
+		FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+		EndFrameHandle.Reset();
+	}
+
+	void FDbgLogTrace::TraceLog(uint64 CallsiteId, std::atomic<bool>& bCallsiteDescribed, const ANSICHAR* File, uint32 Line,
+		const FLogCategoryBase& Category, ELogVerbosity::Type Verbosity, uint64 Cycles)
+	{
+		LogCount.fetch_add(1, std::memory_order_relaxed);
+
+#if DBGLOG_TRACE_ENABLED
+		// Callsites that switch categories at runtime keep the first one they were seen with.
+		if (bCallsiteDescribed.load(std::memory_order_relaxed) == false && bCallsiteDescribed.exchange(true) == false)
+		{
+			TStringBuilder<FName::StringBufferSize> CategoryName;
+			Category.GetCategoryName().AppendString(CategoryName);
+
+			UE_TRACE_LOG(dbgLog, Callsite, dbgLogChannel)
+				<< Callsite.CallsiteId(CallsiteId)
+				<< Callsite.Line(Line)
+				<< Callsite.File(File, FCStringAnsi::Strlen(File))
+				<< Callsite.Category(CategoryName.GetData(), CategoryName.Len());
+		}
+
+		UE_TRACE_LOG(dbgLog, Log, dbgLogChannel)
+			<< Log.Cycle(Cycles)
+			<< Log.CallsiteId(CallsiteId)
+			<< Log.Verbosity(static_cast<uint8>(Verbosity));
+#endif
+	}
+
+	void FDbgLogTrace::PublishCounters()
+	{
+		if (DBGLOG_TRACE_IS_ENABLED() == false)
+		{
+			return;
+		}
+
+		// Logs per second over roughly one second windows, a single frame is too noisy to read anything from.
+		const uint64 Now = FPlatformTime::Cycles64();
+		const uint64 Logs = LogCount.load(std::memory_order_relaxed);
+		const double Seconds = (Now - RateCycles) * FPlatformTime::GetSecondsPerCycle64();
+		if (RateCycles != 0 && Seconds >= 1.0)
+		{
+			TRACE_COUNTER_SET(DbgLogLogsPerSecond, static_cast<int64>((Logs - RateLogCount) / Seconds));
+		}
+		if (RateCycles == 0 || Seconds >= 1.0)
+		{
+			RateCycles = Now;
+			RateLogCount = Logs;
+		}
+
+		TRACE_COUNTER_SET(DbgLogFormattedBytes, static_cast<int64>(FormattedBytes.load(std::memory_order_relaxed)));
+		TRACE_COUNTER_SET(DbgLogSuppressed, static_cast<int64>(SuppressedCount.load(std::memory_order_relaxed)));
+		TRACE_COUNTER_SET(DbgLogDropped, static_cast<int64>(GDbgLogAsyncBackend.GetDroppedCount()));
+	}
+}
+
+#endif
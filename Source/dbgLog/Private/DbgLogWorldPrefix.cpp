@@ -0,0 +1,114 @@
+// Copyright ©  Jack Holland.
+//
+// DbgLOG is free software. It comes without any warranty, to the extent permitted
+// by applicable law. You can redistribute it and/or modify it under the terms
+// of the Do What The Fuck You Want To Public License, Version 2, as published
+// by Sam Hocevar:
+//
+//            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+//                    Version 2, December 2004
+//
+// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+//
+// Everyone is permitted to copy and distribute verbatim or modified
+// copies of this license document, and changing it is allowed as long
+// as the name is changed.
+//
+//            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+//   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+//
+//  0. You just DO WHAT THE FUCK YOU WANT TO.
+
+#include "DbgLogWorldPrefix.h"
+#include "dbgLog.h" // Relative path that must be updated if you move the files location.
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+
+
+#if KEEP_DBG_LOG
+
+namespace DBG::Log
+{
+	FDbgLogWorldPrefixCache GDbgLogWorldPrefixCache;
+
+	namespace
+	{
+		const TCHAR* NetModeToString(ENetMode Mode)
+		{
+			switch (Mode)
+			{
+				case NM_Standalone:			return TEXT("Standalone");
+				case NM_DedicatedServer:	return TEXT("Dedicated Server");
+				case NM_ListenServer:		return TEXT("Listen Server");
+				case NM_Client:				return TEXT("Client");
+				case NM_MAX:				return TEXT("MAX");
+				default:					return TEXT("Unknown");
+			}
+		}
+	}
+
+	void FDbgLogWorldPrefixCache::StartupModule()
+	{
+		PostWorldInitializationHandle = FWorldDelegates::OnPostWorldInitialization.AddLambda(
+			[this](UWorld* World, const UWorld::InitializationValues)
+			{
+				Invalidate(World);
+			});
+
+		WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddLambda(
+			[this](UWorld* World, bool /*bSessionEnded*/, bool /*bCleanupResources*/)
+			{
+				Invalidate(World);
+			});
+	}
+
+	void FDbgLogWorldPrefixCache::ShutdownModule()
+	{
+		FWorldDelegates::OnPostWorldInitialization.Remove(PostWorldInitializationHandle);
+		FWorldDelegates::OnWorldCleanup.Remove(WorldCleanupHandle);
+		PostWorldInitializationHandle.Reset();
+		WorldCleanupHandle.Reset();
+
+		FWriteScopeLock WriteLock(Lock);
+		Entries.Empty();
+	}
+
+	void FDbgLogWorldPrefixCache::AppendPrefix(FStringBuilderBase& Builder, const UWorld* World)
+	{
+		const ENetMode NetMode = World->GetNetMode();
+		{
+			FReadScopeLock ReadLock(Lock);
+			const FEntry* Entry = Entries.Find(World);
+			if (Entry && Entry->NetMode == NetMode)
+			{
+				Builder << Entry->Prefix;
+				return;
+			}
+		}
+
+		const FWorldContext* WorldContext = GEngine ? GEngine->GetWorldContextFromWorld(World) : nullptr;
+		if (WorldContext == nullptr)
+		{
+			// Not cached, the context usually shows up before the world is used for real.
+			Builder << TEXT("[NullWorld] ");
+			return;
+		}
+
+		FEntry NewEntry;
+		NewEntry.NetMode = NetMode;
+		NewEntry.Prefix = FString::Printf(TEXT("[%s | Instance: %d] "), NetModeToString(NetMode), WorldContext->PIEInstance);
+		Builder << NewEntry.Prefix;
+
+		FWriteScopeLock WriteLock(Lock);
+		Entries.Emplace(World, MoveTemp(NewEntry));
+	}
+
+	void FDbgLogWorldPrefixCache::Invalidate(const UWorld* World)
+	{
+		FWriteScopeLock WriteLock(Lock);
+		Entries.Remove(World);
+	}
+}
+
+#endif
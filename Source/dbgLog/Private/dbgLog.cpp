@@ -21,10 +21,37 @@
 #pragma once
 #include "dbgLog.h" // Relative path that must be updated if you move the files location.
 
+#include "Misc/CoreDelegates.h"
+
 
 #if KEEP_DBG_LOG
 DEFINE_LOG_CATEGORY(dbgLOG);
 
+int32 DBG::Log::GDbgLogMaxContainerElements = 1000;
+static FAutoConsoleVariableRef CVarDbgLogMaxContainerElements
+	{
+		TEXT("dbgLog.MaxContainerElements"),
+		DBG::Log::GDbgLogMaxContainerElements,
+		TEXT("How many elements of a container are logged before the rest is summarized as \"... (+N more)\", 0 means no limit.\n")
+		TEXT("A format spec like {0:n=32} overrides it for that argument.")
+	};
+
+float DBG::Log::GDbgLogDedupWindowMs = 0.f;
+static FAutoConsoleVariableRef CVarDbgLogDedupWindowMs
+	{
+		TEXT("dbgLog.Dedup.WindowMs"),
+		DBG::Log::GDbgLogDedupWindowMs,
+		TEXT("If above 0, identical consecutive console logs of a category within this many milliseconds of the first one are swallowed,\n")
+		TEXT("the next log then mentions them as \"(repeated xN over T ms)\", or the end of the frame once the window is over.\n")
+		TEXT("Only applies to logs formatted on the calling thread, logs going to the binary sink or deferred to the async writer\n")
+		TEXT("(dbgLog.Async.DeferFormatting) are never deduplicated."),
+		FConsoleVariableDelegate::CreateLambda([](IConsoleVariable* Variable)
+		{
+			// Don't leave repeats counted under the old window hanging.
+			DBG::Log::GDbgLogSingleton.FlushRepeats(true);
+		})
+	};
+
 FAutoConsoleCommand EnableCategoryCommand
 	{
 		TEXT("dbgLog.EnableCategory"),
@@ -39,10 +66,7 @@ FAutoConsoleCommand EnableCategoryCommand
 
 			if (Input[0] == "All")
 			{
-				for (auto& [_, Cat] : DBG::Log::GDbgLogSingleton.CategoryMap)
-				{
-					Cat.bState = true;
-				}
+				DBG::Log::GDbgLogSingleton.SetAllCategoriesState(true);
 			}
 			else
 			{
@@ -73,10 +97,7 @@ FAutoConsoleCommand DisableCategoryCommand
 
 			if (Input[0] == "All")
 			{
-				for (auto& [_, Cat] : DBG::Log::GDbgLogSingleton.CategoryMap)
-				{
-					Cat.bState = false;
-				}
+				DBG::Log::GDbgLogSingleton.SetAllCategoriesState(false);
 			}
 			else
 			{
@@ -99,9 +120,9 @@ FAutoConsoleCommand PrintDisabledCategories
 			TStringBuilder<256> CategoriesBuilder;
 			int32 DisabledCategoriesNum = 0;
 			int32 EnabledCategoriesNum = 0;
-			for (auto& [CategoryName, Cat] : DBG::Log::GDbgLogSingleton.CategoryMap)
+			DBG::Log::GDbgLogSingleton.ForEachCategory([&](FName CategoryName, bool bState)
 			{
-				if (Cat.bState == false)
+				if (bState == false)
 				{
 					++DisabledCategoriesNum;
 					CategoriesBuilder.Appendf(TEXT("- [Disabled] %s\n"), *CategoryName.ToString());
@@ -111,7 +132,7 @@ FAutoConsoleCommand PrintDisabledCategories
 					++EnabledCategoriesNum;
 					CategoriesBuilder.Appendf(TEXT("- [Enabled]  %s\n"), *CategoryName.ToString());
 				}
-			}
+			});
 
 			if (CategoriesBuilder.Len() > 0)
 			{
@@ -125,6 +146,63 @@ FAutoConsoleCommand PrintDisabledCategories
 		ECVF_Cheat
 	};
 
+FAutoConsoleCommand StatsCommand
+	{
+		TEXT("dbgLog.Stats"),
+		TEXT("Usage: \"dbgLog.Stats [Count]\", Prints the Count (default 50) most expensive dbgLOG callsites since the last `dbgLog.Stats.Reset`,\n")
+		TEXT("with how often they fired or got suppressed and the time spent formatting and emitting. Needs `dbgLog.Stats.Collect 1`."),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Input)
+		{
+			if (DBG::Log::GDbgLogStats.IsCollecting() == false)
+			{
+				UE_LOG(dbgLOG, Warning, TEXT("dbgLOG stats aren't being collected, turn them on with `dbgLog.Stats.Collect 1` or `-dbgLogStats`."));
+			}
+
+			const TArray<DBG::Log::FDbgLogStats::FCallsiteStats> AllStats = DBG::Log::GDbgLogStats.Gather();
+			if (AllStats.Num() == 0)
+			{
+				UE_LOG(dbgLOG, Display, TEXT("No dbgLOG callsite has fired since the stats were last reset."));
+				return;
+			}
+
+			const int32 Count = FMath::Min(Input.Num() > 0 ? FMath::Max(FCString::Atoi(*Input[0]), 1) : 50, AllStats.Num());
+
+			TStringBuilder<4096> StatsBuilder;
+			StatsBuilder.Appendf(TEXT("%10s %10s %10s %10s %10s %10s  %-24s %s\n"),
+				TEXT("Fired"), TEXT("Suppressed"), TEXT("Total ms"), TEXT("Avg us"), TEXT("Format ms"), TEXT("Emit ms"), TEXT("Category"), TEXT("Callsite"));
+
+			for (int32 Index = 0; Index < Count; ++Index)
+			{
+				const DBG::Log::FDbgLogStats::FCallsiteStats& Stats = AllStats[Index];
+				const double TotalMs = FPlatformTime::ToMilliseconds64(Stats.GetTotalCycles());
+				StatsBuilder.Appendf(TEXT("%10llu %10llu %10.3f %10.3f %10.3f %10.3f  %-24s "),
+					Stats.Fired, Stats.Suppressed, TotalMs, Stats.Fired > 0 ? TotalMs * 1000.0 / Stats.Fired : 0.0,
+					FPlatformTime::ToMilliseconds64(Stats.FormatCycles), FPlatformTime::ToMilliseconds64(Stats.EmitCycles),
+					*Stats.Category.ToString());
+				StatsBuilder.Appendf(TEXT("%s:%u\n"), *Stats.File, Stats.Line);
+			}
+
+			if (const uint64 Overflowed = DBG::Log::GDbgLogStats.GetNumOverflowed())
+			{
+				StatsBuilder.Appendf(TEXT("(%llu logs came from callsites that didn't fit into their thread's stats table and aren't listed)\n"), Overflowed);
+			}
+
+			UE_LOG(dbgLOG, Display, TEXT("dbgLOG stats, %d of %d callsites by cost:\n%s"), Count, AllStats.Num(), StatsBuilder.ToString());
+		}),
+		ECVF_Cheat
+	};
+
+FAutoConsoleCommand StatsResetCommand
+	{
+		TEXT("dbgLog.Stats.Reset"),
+		TEXT("Starts the numbers `dbgLog.Stats` reports over from zero."),
+		FConsoleCommandDelegate::CreateLambda([]()
+		{
+			DBG::Log::GDbgLogStats.Reset();
+		}),
+		ECVF_Cheat
+	};
+
 
 
 namespace DBG::Log
@@ -134,11 +212,257 @@ namespace DBG::Log
 	FDbgLogSingleton::FDbgLogSingleton()
 	{
 		// Register our default one immediately.
-		GDbgLogSingleton.CategoryMap.Emplace(dbgLOG.GetCategoryName(), FRegisteredCategory{true});
+		FindOrAddCategoryId(dbgLOG.GetCategoryName());
+	}
+
+	void FDbgLogSingleton::StartupModule()
+	{
+		EndFrameHandle = FCoreDelegates::OnEndFrame.AddLambda([this]() { FlushRepeats(false); });
+	}
+
+	void FDbgLogSingleton::ShutdownModule()
+	{
+		FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+		FlushRepeats(true);
+	}
+
+	void FDbgLogSingleton::FlushRepeats(bool bAll)
+	{
+		if (bAll == false && GDbgLogDedupWindowMs <= 0.f)
+		{
+			return;
+		}
+
+		const uint64 Now = FPlatformTime::Cycles64();
+		const uint64 WindowCycles = static_cast<uint64>(GDbgLogDedupWindowMs / (1000.0 * FPlatformTime::GetSecondsPerCycle64()));
+		const int32 Num = NumCategories.load(std::memory_order_acquire);
+		for (int32 CategoryId = 0; CategoryId < Num; ++CategoryId)
+		{
+			FRegisteredCategory& Entry = CategoryStates[CategoryId];
+			if (Entry.DedupRepeats.load(std::memory_order_relaxed) == 0)
+			{
+				continue;
+			}
+
+			const uint64 WindowStart = Entry.DedupWindowStart.load(std::memory_order_relaxed);
+			if (bAll == false && Now - WindowStart < WindowCycles)
+			{
+				continue;
+			}
+
+			if (bAll)
+			{
+				Entry.DedupHash.store(0, std::memory_order_relaxed);
+			}
+
+			// Whoever takes the count reports it, so a log ending the run at the same time can't report it twice.
+			const uint32 Count = Entry.DedupRepeats.exchange(0, std::memory_order_relaxed);
+			const FDbgLogCallsite* Callsite = Entry.DedupCallsite.load(std::memory_order_relaxed);
+			const FLogCategoryBase* Category = Entry.DedupCategory.load(std::memory_order_relaxed);
+			if (Count == 0 || Callsite == nullptr || Category == nullptr)
+			{
+				continue;
+			}
+
+			const uint64 LastRepeat = Entry.DedupLastRepeat.load(std::memory_order_relaxed);
+			TStringBuilder<64> RepeatBuilder;
+			RepeatBuilder.Appendf(TEXT("(previous message repeated x%u over %.0f ms)"), Count,
+				FPlatformTime::ToMilliseconds64(LastRepeat > WindowStart ? LastRepeat - WindowStart : 0));
+			OutputLog(*Callsite, *Category, static_cast<ELogVerbosity::Type>(Entry.DedupVerbosity.load(std::memory_order_relaxed)), RepeatBuilder.ToString());
+		}
+	}
+
+	int32 FDbgLogSingleton::FindOrAddCategoryId(FName CategoryName)
+	{
+		FScopeLock ScopeLock(&RegistrationLock);
+		if (const int32* Existing = CategoryIds.Find(CategoryName))
+		{
+			return *Existing;
+		}
+
+		const int32 CategoryId = NumCategories.load(std::memory_order_relaxed);
+		if (CategoryId >= MaxCategories)
+		{
+			// Can't track its state, it simply stays enabled.
+			UE_LOG(dbgLOG, Warning, TEXT("Ran out of category slots (%d), %s can't be enabled/disabled."), MaxCategories, *CategoryName.ToString());
+			CategoryIds.Emplace(CategoryName, INDEX_NONE);
+			return INDEX_NONE;
+		}
+
+		CategoryStates[CategoryId].Name = CategoryName;
+		CategoryStates[CategoryId].bState.store(true, std::memory_order_relaxed);
+		CategoryIds.Emplace(CategoryName, CategoryId);
+
+		// Publish the entry, readers only ever look at ids below NumCategories.
+		NumCategories.store(CategoryId + 1, std::memory_order_release);
+		return CategoryId;
+	}
+
+	int32 FDbgLogSingleton::FindCategoryId(FName CategoryName) const
+	{
+		FScopeLock ScopeLock(&RegistrationLock);
+		const int32* Existing = CategoryIds.Find(CategoryName);
+		return Existing ? *Existing : INDEX_NONE;
+	}
+
+
+	FDbgLogCategoryRegistry& FDbgLogCategoryRegistry::Get()
+	{
+		static FDbgLogCategoryRegistry Registry;
+		return Registry;
+	}
+
+	const FDbgLogCategoryHandle* FDbgLogCategoryRegistry::FindOrAdd(FName CategoryName)
+	{
+		FScopeLock ScopeLock(&Lock);
+		return FindOrAddNameHandle_Locked(CategoryName);
+	}
+
+	const FDbgLogCategoryHandle* FDbgLogCategoryRegistry::FindOrAdd(const ANSICHAR* CategoryLiteral)
+	{
+		FScopeLock ScopeLock(&Lock);
+		if (const TUniquePtr<FDbgLogCategoryHandle>* Existing = LiteralHandles.Find(CategoryLiteral))
+		{
+			return Existing->Get();
+		}
+
+		const FDbgLogCategoryHandle* NameHandle = FindOrAddNameHandle_Locked(FName(CategoryLiteral));
+
+		TUniquePtr<FDbgLogCategoryHandle>& Handle = LiteralHandles.Emplace(CategoryLiteral, MakeUnique<FDbgLogCategoryHandle>());
+		Handle->Literal = CategoryLiteral;
+		Handle->Name = NameHandle->Name;
+		Handle->Category = NameHandle->Category;
+		Handle->StateId = NameHandle->StateId;
+		return Handle.Get();
+	}
+
+	const FDbgLogCategoryHandle* FDbgLogCategoryRegistry::FindOrAdd(const FLogCategoryBase& ExistingCategory)
+	{
+		FScopeLock ScopeLock(&Lock);
+		if (const TUniquePtr<FDbgLogCategoryHandle>* Existing = ExistingHandles.Find(&ExistingCategory))
+		{
+			return Existing->Get();
+		}
+
+		TUniquePtr<FDbgLogCategoryHandle>& Handle = ExistingHandles.Emplace(&ExistingCategory, MakeUnique<FDbgLogCategoryHandle>());
+		Handle->Existing = &ExistingCategory;
+		Handle->Name = ExistingCategory.GetCategoryName();
+		Handle->Category = &ExistingCategory;
+		Handle->StateId = GDbgLogSingleton.FindOrAddCategoryId(Handle->Name);
+		return Handle.Get();
+	}
+
+	const FDbgLogCategoryHandle* FDbgLogCategoryRegistry::FindOrAddNameHandle_Locked(FName CategoryName)
+	{
+		if (const TUniquePtr<FDbgLogCategoryHandle>* Existing = NameHandles.Find(CategoryName))
+		{
+			return Existing->Get();
+		}
+
+		TUniquePtr<FDbgLogCategoryHandle>& Handle = NameHandles.Emplace(CategoryName, MakeUnique<FDbgLogCategoryHandle>());
+		Handle->Name = CategoryName;
+
+		if (CategoryName.IsNone() || CategoryName == dbgLOG.GetCategoryName())
+		{
+			Handle->Category = &dbgLOG;
+		}
+		else
+		{
+			// We prefix all of them with "dbg" to avoid clashing with categories the engine already defines.
+			const FName FullName = FName{FString::Format(TEXT("dbg{0}"), {CategoryName.ToString()})};
+			Handle->Category = Categories.Emplace(CategoryName, MakeUnique<FDbgLogDynamicCategory>(FullName)).Get();
+		}
+
+		Handle->StateId = GDbgLogSingleton.FindOrAddCategoryId(Handle->Category->GetCategoryName());
+		return Handle.Get();
+	}
+
+
+	void AppendDateTime(FStringBuilderBase& Builder, uint64 Cycles, TStringView<TCHAR> Format)
+	{
+		struct FDateTimeCache
+		{
+			// Cycles64 to wall clock anchor, taken again every so often so daylight saving and clock changes catch up.
+			uint64 AnchorCycles = 0;
+			FDateTime AnchorTime;
+
+			FString Format;
+			bool bHasMilliseconds = false;
+			int64 RenderedUnit = -1;
+			FString Rendered;
+		};
+		thread_local FDateTimeCache Cache;
+
+		static constexpr double AnchorSeconds = 60.0;
+		const double SecondsPerCycle = FPlatformTime::GetSecondsPerCycle64();
+		if (Cache.RenderedUnit < 0 || static_cast<double>(static_cast<int64>(Cycles - Cache.AnchorCycles)) * SecondsPerCycle > AnchorSeconds)
+		{
+			Cache.AnchorCycles = FPlatformTime::Cycles64();
+			Cache.AnchorTime = FDateTime::Now();
+			Cache.RenderedUnit = -1;
+		}
+
+		// Same default as FDateTime::ToString().
+		const FStringView EffectiveFormat = Format.IsEmpty() ? FStringView(TEXT("%Y.%m.%d-%H.%M.%S")) : FStringView(Format);
+		if (FStringView(Cache.Format).Equals(EffectiveFormat, ESearchCase::CaseSensitive) == false)
+		{
+			Cache.Format = FString(EffectiveFormat);
+			Cache.bHasMilliseconds = Cache.Format.Contains(TEXT("%s"), ESearchCase::CaseSensitive);
+			Cache.RenderedUnit = -1;
+		}
+
+		// Signed, the stamp can be a little older than the anchor.
+		const double Seconds = static_cast<double>(static_cast<int64>(Cycles - Cache.AnchorCycles)) * SecondsPerCycle;
+		const FDateTime Time = Cache.AnchorTime + FTimespan::FromSeconds(Seconds);
+		const int64 Unit = Time.GetTicks() / (Cache.bHasMilliseconds ? ETimespan::TicksPerMillisecond : ETimespan::TicksPerSecond);
+		if (Unit != Cache.RenderedUnit)
+		{
+			Cache.Rendered = Time.ToString(*Cache.Format);
+			Cache.RenderedUnit = Unit;
+		}
+
+		Builder << Cache.Rendered;
 	}
 }
 
 
 #endif
 
-IMPLEMENT_MODULE(FDefaultModuleImpl, dbgLog)
+
+
+class FDbgLogModule : public IModuleInterface
+{
+public:
+	virtual void StartupModule() override
+	{
+#if KEEP_DBG_LOG
+		DBG::Log::GDbgLogSingleton.StartupModule();
+		DBG::Log::GDbgLogAsyncBackend.StartupModule();
+		DBG::Log::GDbgLogBinarySink.StartupModule();
+		DBG::Log::GDbgLogScreenMessages.StartupModule();
+		DBG::Log::GDbgLogGameThread.StartupModule();
+		DBG::Log::GDbgLogWorldPrefixCache.StartupModule();
+		DBG::Log::GDbgLogDebugDraw.StartupModule();
+		DBG::Log::GDbgLogTrace.StartupModule();
+		DBG::Log::GDbgLogStats.StartupModule();
+#endif
+	}
+
+	virtual void ShutdownModule() override
+	{
+#if KEEP_DBG_LOG
+		// Report any pending repeats while the async backend can still write them.
+		DBG::Log::GDbgLogSingleton.ShutdownModule();
+		DBG::Log::GDbgLogAsyncBackend.ShutdownModule();
+		DBG::Log::GDbgLogBinarySink.ShutdownModule();
+		DBG::Log::GDbgLogScreenMessages.ShutdownModule();
+		DBG::Log::GDbgLogGameThread.ShutdownModule();
+		DBG::Log::GDbgLogWorldPrefixCache.ShutdownModule();
+		DBG::Log::GDbgLogDebugDraw.ShutdownModule();
+		DBG::Log::GDbgLogTrace.ShutdownModule();
+		DBG::Log::GDbgLogStats.ShutdownModule();
+#endif
+	}
+};
+
+IMPLEMENT_MODULE(FDbgLogModule, dbgLog)
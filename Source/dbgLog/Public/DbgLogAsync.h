@@ -0,0 +1,220 @@
+// Copyright ©  Jack Holland.
+//
+// DbgLOG is free software. It comes without any warranty, to the extent permitted
+// by applicable law. You can redistribute it and/or modify it under the terms
+// of the Do What The Fuck You Want To Public License, Version 2, as published
+// by Sam Hocevar:
+//
+//            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+//                    Version 2, December 2004
+//
+// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+//
+// Everyone is permitted to copy and distribute verbatim or modified
+// copies of this license document, and changing it is allowed as long
+// as the name is changed.
+//
+//            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+//   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+//
+//  0. You just DO WHAT THE FUCK YOU WANT TO.
+#pragma once
+#include <atomic>
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "Templates/UniquePtr.h"
+
+#include "LLog.h"
+
+class FEvent;
+class FRunnableThread;
+
+
+namespace DBG::Log
+{
+	/**
+	 * Bounded multi producer, single consumer queue (Dmitry Vyukov's bounded queue with the consumer side simplified).
+	 * Producers never block, TryEnqueue simply fails when the queue is full, and no locks are taken on either side.
+	 */
+	template<typename T>
+	class TDbgLogBoundedQueue
+	{
+	public:
+		// Capacity is rounded up to a power of two.
+		explicit TDbgLogBoundedQueue(uint32 InCapacity)
+			: Capacity(FMath::RoundUpToPowerOfTwo(FMath::Max<uint32>(InCapacity, 2)))
+			, Mask(Capacity - 1)
+			, Slots(MakeUnique<FSlot[]>(Capacity))
+		{
+			for (uint32 Index = 0; Index < Capacity; ++Index)
+			{
+				Slots[Index].Sequence.store(Index, std::memory_order_relaxed);
+			}
+		}
+
+		// Safe to call from any number of threads at once.
+		bool TryEnqueue(T&& Item)
+		{
+			FSlot* Slot = nullptr;
+			uint64 Pos = EnqueuePos.load(std::memory_order_relaxed);
+			for (;;)
+			{
+				Slot = &Slots[Pos & Mask];
+				const uint64 Sequence = Slot->Sequence.load(std::memory_order_acquire);
+				const int64 Diff = static_cast<int64>(Sequence) - static_cast<int64>(Pos);
+				if (Diff == 0)
+				{
+					if (EnqueuePos.compare_exchange_weak(Pos, Pos + 1, std::memory_order_relaxed))
+					{
+						break;
+					}
+				}
+				else if (Diff < 0)
+				{
+					// The consumer hasn't freed this slot up yet, we're full.
+					return false;
+				}
+				else
+				{
+					Pos = EnqueuePos.load(std::memory_order_relaxed);
+				}
+			}
+
+			Slot->Value = MoveTemp(Item);
+			Slot->Sequence.store(Pos + 1, std::memory_order_release);
+			return true;
+		}
+
+		// Must only ever be called from the one consumer thread.
+		bool TryDequeue(T& OutItem)
+		{
+			FSlot& Slot = Slots[DequeuePos & Mask];
+			const uint64 Sequence = Slot.Sequence.load(std::memory_order_acquire);
+			if (static_cast<int64>(Sequence) - static_cast<int64>(DequeuePos + 1) < 0)
+			{
+				return false;
+			}
+
+			OutItem = MoveTemp(Slot.Value);
+			Slot.Sequence.store(DequeuePos + Capacity, std::memory_order_release);
+			++DequeuePos;
+			return true;
+		}
+
+	private:
+		struct FSlot
+		{
+			std::atomic<uint64> Sequence{0};
+			T Value;
+		};
+
+		const uint32 Capacity;
+		const uint64 Mask;
+		TUniquePtr<FSlot[]> Slots;
+
+		// Keep the producer and consumer cursors on their own cache lines.
+		alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint64> EnqueuePos{0};
+		alignas(PLATFORM_CACHE_LINE_SIZE) uint64 DequeuePos = 0;
+	};
+
+
+	// A log on its way to the output devices.
+	struct FDbgLogRecord
+	{
+		using FLogRecord = ::UE::Logging::Private::FStaticBasicLogRecord;
+
+		const FLogCategoryBase* Category	= nullptr;
+		const ANSICHAR* File				= nullptr;
+		int32 Line							= 0;
+		ELogVerbosity::Type Verbosity		= ELogVerbosity::Log;
+
+		// FPlatformTime::Cycles64() of when the log was made.
+		uint64 Cycles						= 0;
+
+		// The finished message, for deferred records only the prefix until the writer appends the formatted arguments.
+		FString Message;
+
+		// The callsite's static record for this verbosity, BasicLog registers the log point by its address so it has to
+		// be the callsite's own and not one shared by every record.
+		const FLogRecord* LogRecord			= nullptr;
+
+		// Only set for deferred records, the raw arguments get formatted on the writer thread.
+		std::wstring_view Format;
+		FDeferredFormatFunc FormatFunc		= nullptr;
+		TArray<uint8, TInlineAllocator<64>> ArgData;
+
+		// Set for `.LogDateAndTime()`, the writer renders the date from Cycles in front of the message.
+		bool bLogDateAndTime				= false;
+		FString DateTimeFormat;
+	};
+
+
+	/**
+	 * Opt-in (`dbgLog.Async 1` or `-dbgLogAsync`) backend that moves the output device work off the calling thread.
+	 * Logs are pushed into a bounded queue and a dedicated thread drains them into GLog, if the queue is ever full the
+	 * log is dropped and counted rather than stalling the caller. Fatal logs, module shutdown and `dbgLog.Flush`
+	 * drain the queue before returning.
+	 */
+	class DBGLOG_API FDbgLogAsyncBackend : public FRunnable
+	{
+	public:
+		static constexpr uint32 QueueCapacity = 16384;
+
+		FDbgLogAsyncBackend();
+		virtual ~FDbgLogAsyncBackend() override;
+
+		// Cheap enough to be called for every log.
+		bool IsActive() const { return bActive.load(std::memory_order_relaxed); }
+
+		// Whether logs with only deferrable arguments (see TCanDeferFormat) should leave the formatting to the writer thread.
+		bool ShouldDeferFormatting() const { return IsActive() && bDeferFormatting.load(std::memory_order_relaxed); }
+		void SetDeferFormatting(bool bDefer) { bDeferFormatting.store(bDefer, std::memory_order_relaxed); }
+
+		// Called by the module, picks up `dbgLog.Async`/`-dbgLogAsync` and makes sure nothing is left behind on shutdown.
+		void StartupModule();
+		void ShutdownModule();
+
+		// Starts or stops the writer thread, stopping drains everything that is still queued.
+		void SetEnabled(bool bEnabled);
+
+		// Returns false (and counts it as dropped) if the queue is full.
+		bool Enqueue(FDbgLogRecord&& Record);
+
+		// Blocks until everything enqueued before this call has been handed to the output devices.
+		void Flush();
+
+		uint64 GetDroppedCount() const { return DroppedCount.load(std::memory_order_relaxed); }
+
+		//~ FRunnable
+		virtual uint32 Run() override;
+		virtual void Stop() override;
+		//~ FRunnable
+
+	private:
+		// Returns how many records were written.
+		int32 Drain();
+		void ReportDropped();
+
+		TDbgLogBoundedQueue<FDbgLogRecord> Queue{QueueCapacity};
+
+		std::atomic<bool> bActive{false};
+		std::atomic<bool> bDeferFormatting{false};
+		std::atomic<bool> bStopping{false};
+		std::atomic<uint64> EnqueuedCount{0};
+		std::atomic<uint64> WrittenCount{0};
+		std::atomic<uint64> DroppedCount{0};
+		uint64 ReportedDroppedCount = 0;
+
+		FEvent* WakeEvent = nullptr;
+		FRunnableThread* Thread = nullptr;
+
+		// Guards starting/stopping the thread.
+		FCriticalSection StateLock;
+
+		// Makes sure there is only ever one consumer, normally the writer thread but whoever stops it drains the rest.
+		FCriticalSection DrainLock;
+	};
+
+	DBGLOG_API extern FDbgLogAsyncBackend GDbgLogAsyncBackend;
+}
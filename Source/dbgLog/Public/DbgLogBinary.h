@@ -0,0 +1,189 @@
+// Copyright ©  Jack Holland.
+//
+// DbgLOG is free software. It comes without any warranty, to the extent permitted
+// by applicable law. You can redistribute it and/or modify it under the terms
+// of the Do What The Fuck You Want To Public License, Version 2, as published
+// by Sam Hocevar:
+//
+//            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+//                    Version 2, December 2004
+//
+// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+//
+// Everyone is permitted to copy and distribute verbatim or modified
+// copies of this license document, and changing it is allowed as long
+// as the name is changed.
+//
+//            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+//   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+//
+//  0. You just DO WHAT THE FUCK YOU WANT TO.
+#pragma once
+#include <atomic>
+#include <format>
+#include <source_location>
+#include <string_view>
+#include <type_traits>
+
+#include "CoreMinimal.h"
+#include "Templates/UniquePtr.h"
+
+#include "LLog.h"
+
+
+namespace DBG::Log
+{
+	// Tags of the packed arguments in a binary record, keep in sync with Tools/DbgLogDecoder.
+	enum class EDbgLogBinaryArgument : uint8
+	{
+		Bool = 1,
+		Int,	// Zigzag varint
+		UInt,	// Varint
+		Float,
+		Double,
+		Char,	// Varint code point
+		String,	// Varint byte count followed by UTF-8
+	};
+
+	// Little endian base 128, most of what we write is small.
+	template<typename Allocator>
+	void WriteBinaryVarUInt(TArray<uint8, Allocator>& Out, uint64 Value)
+	{
+		while (Value >= 0x80)
+		{
+			Out.Add(static_cast<uint8>(Value) | 0x80);
+			Value >>= 7;
+		}
+		Out.Add(static_cast<uint8>(Value));
+	}
+
+	template<typename Allocator>
+	void WriteBinaryVarInt(TArray<uint8, Allocator>& Out, int64 Value)
+	{
+		WriteBinaryVarUInt(Out, (static_cast<uint64>(Value) << 1) ^ static_cast<uint64>(Value >> 63));
+	}
+
+	template<typename Allocator>
+	void WriteBinaryString(TArray<uint8, Allocator>& Out, FStringView Value)
+	{
+		const FTCHARToUTF8 Utf8(Value.GetData(), Value.Len());
+		WriteBinaryVarUInt(Out, Utf8.Length());
+		Out.Append(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+	}
+
+	/**
+	 * Numbers are stored as is so the decoder can apply the format spec to them, anything else goes through
+	 * FormatArgument and is stored as the text it would have printed.
+	 */
+	template<typename Allocator, typename T>
+	void WriteBinaryArgument(TArray<uint8, Allocator>& Out, const T& Value)
+	{
+		using V = std::remove_cvref_t<T>;
+		if constexpr (std::is_same_v<V, bool>)
+		{
+			Out.Add(static_cast<uint8>(EDbgLogBinaryArgument::Bool));
+			Out.Add(Value ? 1 : 0);
+		}
+		else if constexpr (std::is_same_v<V, TCHAR> || std::is_same_v<V, ANSICHAR>)
+		{
+			Out.Add(static_cast<uint8>(EDbgLogBinaryArgument::Char));
+			WriteBinaryVarUInt(Out, static_cast<std::make_unsigned_t<V>>(Value));
+		}
+		else if constexpr (std::is_integral_v<V> && std::is_signed_v<V>)
+		{
+			Out.Add(static_cast<uint8>(EDbgLogBinaryArgument::Int));
+			WriteBinaryVarInt(Out, Value);
+		}
+		else if constexpr (std::is_integral_v<V>)
+		{
+			Out.Add(static_cast<uint8>(EDbgLogBinaryArgument::UInt));
+			WriteBinaryVarUInt(Out, Value);
+		}
+		else if constexpr (std::is_same_v<V, float>)
+		{
+			Out.Add(static_cast<uint8>(EDbgLogBinaryArgument::Float));
+			Out.Append(reinterpret_cast<const uint8*>(&Value), sizeof(float));
+		}
+		else if constexpr (std::is_floating_point_v<V>)
+		{
+			const double AsDouble = static_cast<double>(Value);
+			Out.Add(static_cast<uint8>(EDbgLogBinaryArgument::Double));
+			Out.Append(reinterpret_cast<const uint8*>(&AsDouble), sizeof(double));
+		}
+		else
+		{
+			const std::wstring Text = std::format(L"{}", FormatArgument(Value));
+			Out.Add(static_cast<uint8>(EDbgLogBinaryArgument::String));
+			WriteBinaryString(Out, FStringView(Text.data(), static_cast<int32>(Text.size())));
+		}
+	}
+
+
+	/**
+	 * Opt-in (`dbgLog.Binary 1` or `-dbgLogBinary`) sink that writes console logs to a compact `.dbglog` file in the
+	 * project log directory instead of the text log. The format string, file and line of a callsite and the name of a
+	 * category are written once, after that a record is only the callsite and category ids, a timestamp delta, the
+	 * verbosity and the packed arguments.
+	 * Tools/DbgLogDecoder turns the file back into text or JSON.
+	 */
+	class DBGLOG_API FDbgLogBinarySink
+	{
+	public:
+		static constexpr uint32 Version = 2;
+
+		FDbgLogBinarySink();
+		~FDbgLogBinarySink();
+
+		// Cheap enough to be called for every log.
+		bool IsEnabled() const { return bEnabled.load(std::memory_order_relaxed); }
+
+		// Called by the module, picks up `dbgLog.Binary`/`-dbgLogBinary` and closes the file on shutdown.
+		void StartupModule();
+		void ShutdownModule();
+
+		// Enabling starts a new file, disabling closes the current one.
+		void SetEnabled(bool bEnable);
+
+		/**
+		 * @param CallsiteId	Owned by the callsite, lets us know whether its dictionary entry is already in the file.
+		 * @param Cycles		FPlatformTime::Cycles64() of when the log was made.
+		 * @param Prefix		Whatever dbgLOG put in front of the message (prefix, world, source location...), usually empty.
+		 */
+		template<typename... A>
+		void Write(std::atomic<uint64>& CallsiteId, const std::source_location& Location, uint64 Cycles, std::wstring_view Format,
+			const FLogCategoryBase& Category, ELogVerbosity::Type Verbosity, FStringView Prefix, const A&... Args)
+		{
+			static_assert(sizeof...(A) <= MAX_uint8, "Too many arguments for a binary record.");
+
+			TArray<uint8, TInlineAllocator<256>> Arguments;
+			WriteBinaryString(Arguments, Prefix);
+			Arguments.Add(static_cast<uint8>(sizeof...(A)));
+			(WriteBinaryArgument(Arguments, Args), ...);
+
+			WriteRecord(CallsiteId, Location, Cycles, Format, Category, Verbosity, Arguments);
+		}
+
+		// Pushes everything written so far to disk.
+		void Flush();
+
+	private:
+		void WriteRecord(std::atomic<uint64>& CallsiteId, const std::source_location& Location, uint64 Cycles, std::wstring_view Format,
+			const FLogCategoryBase& Category, ELogVerbosity::Type Verbosity, TConstArrayView<uint8> Arguments);
+
+		std::atomic<bool> bEnabled{false};
+
+		// Everything below is only touched under the lock.
+		FCriticalSection Lock;
+		TUniquePtr<FArchive> Writer;
+
+		// Bumped for every new file, so callsites know their id (and dictionary entry) is from an older one.
+		uint32 Generation = 0;
+		uint32 NextCallsiteId = 0;
+
+		// Per file, the category goes into every record as a callsite (or the Blueprint one) can log to several.
+		TMap<const FLogCategoryBase*, uint32> CategoryIds;
+		uint64 LastCycles = 0;
+	};
+
+	DBGLOG_API extern FDbgLogBinarySink GDbgLogBinarySink;
+}
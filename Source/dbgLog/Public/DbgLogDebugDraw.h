@@ -0,0 +1,117 @@
+// Copyright ©  Jack Holland.
+//
+// DbgLOG is free software. It comes without any warranty, to the extent permitted
+// by applicable law. You can redistribute it and/or modify it under the terms
+// of the Do What The Fuck You Want To Public License, Version 2, as published
+// by Sam Hocevar:
+//
+//            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+//                    Version 2, December 2004
+//
+// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+//
+// Everyone is permitted to copy and distribute verbatim or modified
+// copies of this license document, and changing it is allowed as long
+// as the name is changed.
+//
+//            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+//   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+//
+//  0. You just DO WHAT THE FUCK YOU WANT TO.
+#pragma once
+#include "CoreMinimal.h"
+#include "Components/LineBatchComponent.h"
+
+
+namespace DBG::Log
+{
+	/**
+	 * Backs the `.DrawDebug*()` builder options. Instead of every shape going through the engine's DrawDebug* functions
+	 * (and ending up as a handful of separate line batcher calls), the shapes of a frame are tessellated straight into
+	 * contiguous per world arrays and handed to each ULineBatchComponent in one DrawLines call after the actors ticked
+	 * (or at the end of the frame for worlds that didn't tick them). Follows the engine's rules for which line batcher a
+	 * shape goes to and how long it stays, and draws nothing without ENABLE_DRAW_DEBUG like the engine's functions.
+	 *
+	 * Game thread only, the builder options make sure of that.
+	 */
+	class DBGLOG_API FDbgLogDebugDrawBatcher
+	{
+	public:
+		void StartupModule();
+		void ShutdownModule();
+
+		void AddLine(const UWorld* World, const FVector& Start, const FVector& End, const FColor& Color,
+			bool bPersistentLines, float LifeTime, uint8 DepthPriority, float Thickness);
+
+		void AddPoint(const UWorld* World, const FVector& Position, float Size, const FColor& Color,
+			bool bPersistentLines, float LifeTime, uint8 DepthPriority);
+
+		void AddDirectionalArrow(const UWorld* World, const FVector& Start, const FVector& End, float ArrowSize,
+			const FColor& Color, bool bPersistentLines, float LifeTime, uint8 DepthPriority, float Thickness);
+
+		// Axis aligned.
+		void AddBox(const UWorld* World, const FVector& Center, const FVector& Extent, const FColor& Color,
+			bool bPersistentLines, float LifeTime, uint8 DepthPriority, float Thickness);
+
+		void AddSphere(const UWorld* World, const FVector& Center, float Radius, int32 Segments, const FColor& Color,
+			bool bPersistentLines, float LifeTime, uint8 DepthPriority, float Thickness);
+
+		void AddCylinder(const UWorld* World, const FVector& Start, const FVector& End, float Radius, int32 Segments,
+			const FColor& Color, bool bPersistentLines, float LifeTime, uint8 DepthPriority, float Thickness);
+
+		// Angles are in radians.
+		void AddCone(const UWorld* World, const FVector& Origin, const FVector& Direction, float Length, float AngleWidth,
+			float AngleHeight, int32 NumSides, const FColor& Color, bool bPersistentLines, float LifeTime,
+			uint8 DepthPriority, float Thickness);
+
+		void AddCapsule(const UWorld* World, const FVector& Center, float HalfHeight, float Radius, const FQuat& Rotation,
+			const FColor& Color, bool bPersistentLines, float LifeTime, uint8 DepthPriority, float Thickness);
+
+	private:
+		// Same split as the engine, see GetDebugLineBatcher in DrawDebugHelpers.cpp.
+		enum EBatcher : uint8
+		{
+			WorldBatcher,
+			PersistentBatcher,
+			ForegroundBatcher,
+			NumBatchers,
+		};
+
+		struct FWorldBatch
+		{
+			TArray<FBatchedLine> Lines[NumBatchers];
+			TArray<FBatchedPoint> Points[NumBatchers];
+		};
+
+		// Where a shape's lines go and with which remaining life time.
+		struct FTarget
+		{
+			TArray<FBatchedLine>* Lines = nullptr;
+			TArray<FBatchedPoint>* Points = nullptr;
+			float LifeTime = 0.f;
+		};
+
+		// Returns a target without any arrays if this world doesn't draw debug lines at all.
+		FTarget GetTarget(const UWorld* World, bool bPersistentLines, float LifeTime, uint8 DepthPriority);
+
+		static ULineBatchComponent* GetLineBatcher(const UWorld* World, EBatcher Batcher);
+
+		// (Cos, Sin) of the angles 0, 2pi/N, ... 2pi, kept around since most shapes of a frame use the same N.
+		TConstArrayView<FVector2D> GetUnitCircle(int32 NumSides);
+
+		void AddCircle(const FTarget& Target, const FVector& Base, const FVector& X, const FVector& Y, const FLinearColor& Color,
+			double Radius, int32 NumSides, int32 SidesToDraw, uint8 DepthPriority, float Thickness);
+
+		void Submit(const UWorld* World);
+
+		TMap<const UWorld*, FWorldBatch> Batches;
+		TArray<FVector2D> UnitCircle;
+		int32 UnitCircleSides = 0;
+
+		FDelegateHandle PostActorTickHandle;
+		FDelegateHandle WorldCleanupHandle;
+		FDelegateHandle EndFrameHandle;
+	};
+
+	DBGLOG_API extern FDbgLogDebugDrawBatcher GDbgLogDebugDraw;
+}
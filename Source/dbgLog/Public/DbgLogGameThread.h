@@ -0,0 +1,61 @@
+// Copyright ©  Jack Holland.
+//
+// DbgLOG is free software. It comes without any warranty, to the extent permitted
+// by applicable law. You can redistribute it and/or modify it under the terms
+// of the Do What The Fuck You Want To Public License, Version 2, as published
+// by Sam Hocevar:
+//
+//            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+//                    Version 2, December 2004
+//
+// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+//
+// Everyone is permitted to copy and distribute verbatim or modified
+// copies of this license document, and changing it is allowed as long
+// as the name is changed.
+//
+//            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+//   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+//
+//  0. You just DO WHAT THE FUCK YOU WANT TO.
+#pragma once
+#include "CoreMinimal.h"
+#include "Containers/MpscQueue.h"
+
+
+namespace DBG::Log
+{
+	/**
+	 * Slate notifications, the message log, message dialogs, debug drawing and the visual logger all have to be used from
+	 * the game thread. Logs from any other thread hand that work to this lock free queue instead and it all gets run
+	 * in one batch at the end of the frame, on the game thread it still happens right away.
+	 */
+	class DBGLOG_API FDbgLogGameThreadDispatcher
+	{
+	public:
+		void StartupModule();
+		void ShutdownModule();
+
+		template<typename FuncType>
+		void Run(FuncType&& Func)
+		{
+			if (IsInGameThread())
+			{
+				Invoke(Func);
+			}
+			else
+			{
+				Queue.Enqueue(TUniqueFunction<void()>(Forward<FuncType>(Func)));
+			}
+		}
+
+		// Runs everything queued so far, game thread only.
+		void Dispatch();
+
+	private:
+		TMpscQueue<TUniqueFunction<void()>> Queue;
+		FDelegateHandle EndFrameHandle;
+	};
+
+	DBGLOG_API extern FDbgLogGameThreadDispatcher GDbgLogGameThread;
+}
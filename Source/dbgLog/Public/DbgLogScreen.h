@@ -0,0 +1,72 @@
+// Copyright ©  Jack Holland.
+//
+// DbgLOG is free software. It comes without any warranty, to the extent permitted
+// by applicable law. You can redistribute it and/or modify it under the terms
+// of the Do What The Fuck You Want To Public License, Version 2, as published
+// by Sam Hocevar:
+//
+//            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+//                    Version 2, December 2004
+//
+// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+//
+// Everyone is permitted to copy and distribute verbatim or modified
+// copies of this license document, and changing it is allowed as long
+// as the name is changed.
+//
+//            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+//   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+//
+//  0. You just DO WHAT THE FUCK YOU WANT TO.
+#pragma once
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+
+class UCanvas;
+class APlayerController;
+
+
+namespace DBG::Log
+{
+	/**
+	 * dbgLog's own on-screen messages. A fixed amount of entries keyed by a stable 64 bit key, a message with a key that is
+	 * already on screen is updated in place (reusing the entry's string memory) rather than adding a new entry every frame.
+	 * Drawn through UDebugDrawService on the "Game" show flag below the engine's own on-screen messages, newest first like
+	 * them, honours `DisableAllScreenMessages`.
+	 */
+	class DBGLOG_API FDbgLogScreenMessages
+	{
+	public:
+		static constexpr int32 Capacity = 128;
+
+		void StartupModule();
+		void ShutdownModule();
+
+		// When full, the entry closest to expiring is replaced.
+		void AddOrUpdate(uint64 Key, float Duration, FColor Color, const TCHAR* Message);
+
+		// Removes every message.
+		void Clear();
+
+	private:
+		void Draw(UCanvas* Canvas, APlayerController* PlayerController);
+
+		struct FEntry
+		{
+			// Zero marks a free entry.
+			uint64 Key = 0;
+			// When the key got its entry, updating a message keeps its place on screen.
+			uint64 Sequence = 0;
+			double ExpireTime = 0.0;
+			FColor Color = FColor::White;
+			FString Text;
+		};
+
+		FEntry Entries[Capacity];
+		uint64 NextSequence = 0;
+		FCriticalSection Lock;
+		FDelegateHandle DrawHandle;
+	};
+
+	DBGLOG_API extern FDbgLogScreenMessages GDbgLogScreenMessages;
+}
@@ -0,0 +1,140 @@
+// Copyright ©  Jack Holland.
+//
+// DbgLOG is free software. It comes without any warranty, to the extent permitted
+// by applicable law. You can redistribute it and/or modify it under the terms
+// of the Do What The Fuck You Want To Public License, Version 2, as published
+// by Sam Hocevar:
+//
+//            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+//                    Version 2, December 2004
+//
+// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+//
+// Everyone is permitted to copy and distribute verbatim or modified
+// copies of this license document, and changing it is allowed as long
+// as the name is changed.
+//
+//            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+//   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+//
+//  0. You just DO WHAT THE FUCK YOU WANT TO.
+#pragma once
+#include <atomic>
+
+#include "CoreMinimal.h"
+#include "Templates/UniquePtr.h"
+
+
+namespace DBG::Log
+{
+	struct FDbgLogCallsite;
+
+	/**
+	 * Per callsite hit counts and cost behind `dbgLog.Stats`, collected while `dbgLog.Stats.Collect` is on (or with `-dbgLogStats`).
+	 * Every thread counts into its own table that only it ever writes to, so the hot path takes no locks and does no
+	 * atomic read-modify-writes, `dbgLog.Stats` sums the tables of all threads whenever it's asked to. A table is folded
+	 * into the totals and freed when its thread exits.
+	 *
+	 * Callsites are only used as keys, where they are is copied on first use so the stats outlive the module that logged.
+	 */
+	class DBGLOG_API FDbgLogStats
+	{
+	public:
+		struct FCallsiteStats
+		{
+			FString File;
+			uint32 Line = 0;
+
+			// The category the callsite last resolved to, None if it never got past the gate.
+			FName Category;
+
+			// Calls that made it through ShouldLog, and the ones it turned away.
+			uint64 Fired = 0;
+			uint64 Suppressed = 0;
+
+			// Spent in FormatMessageTo, and in the rest of Log (prefix, sinks...).
+			uint64 FormatCycles = 0;
+			uint64 EmitCycles = 0;
+
+			uint64 GetTotalCycles() const { return FormatCycles + EmitCycles; }
+		};
+
+		FDbgLogStats();
+		~FDbgLogStats();
+
+		// Called by the module, picks up `dbgLog.Stats.Collect`/`-dbgLogStats`.
+		void StartupModule();
+		void ShutdownModule();
+
+		// Cheap enough to be called for every log.
+		bool IsCollecting() const { return bCollecting.load(std::memory_order_relaxed); }
+		void SetCollecting(bool bCollect) { bCollecting.store(bCollect, std::memory_order_relaxed); }
+
+		void AddSuppressed(const FDbgLogCallsite& Callsite);
+		void AddFired(const FDbgLogCallsite& Callsite, uint64 FormatCycles, uint64 EmitCycles);
+
+		// Everything counted since the last Reset, the most expensive callsites first.
+		TArray<FCallsiteStats> Gather() const;
+
+		// The thread tables are never written to by anyone but their thread, so this remembers the current totals instead.
+		void Reset();
+
+		// Logs from callsites that didn't fit into their thread's table anymore, these aren't in Gather.
+		uint64 GetNumOverflowed() const;
+
+	private:
+		struct FThreadTable;
+		struct FThreadTableOwner;
+
+		FThreadTable& GetThreadTable();
+
+		// Called once the table's thread is gone, folds it into RetiredTotals and frees it.
+		void RetireThreadTable(FThreadTable* Table);
+
+		// Sums the retired totals and all thread tables as they are right now.
+		TMap<const FDbgLogCallsite*, FCallsiteStats> Sum() const;
+
+		std::atomic<bool> bCollecting{false};
+
+		// Only taken when a thread counts for the first time or exits, and by the console commands.
+		mutable FCriticalSection Lock;
+		TArray<TUniquePtr<FThreadTable>> ThreadTables;
+		TMap<const FDbgLogCallsite*, FCallsiteStats> RetiredTotals;
+		uint64 RetiredOverflowed = 0;
+		TMap<const FDbgLogCallsite*, FCallsiteStats> ResetBaseline;
+		uint64 ResetOverflowed = 0;
+	};
+
+	DBGLOG_API extern FDbgLogStats GDbgLogStats;
+
+
+	// Times one Log call for FDbgLogStats, does nothing unless the stats are being collected.
+	class FDbgLogStatsScope
+	{
+	public:
+		FDbgLogStatsScope(const FDbgLogCallsite& InCallsite, uint64 InStartCycles)
+			: Callsite(GDbgLogStats.IsCollecting() ? &InCallsite : nullptr)
+			, StartCycles(InStartCycles)
+		{
+		}
+
+		~FDbgLogStatsScope()
+		{
+			if (Callsite)
+			{
+				const uint64 TotalCycles = FPlatformTime::Cycles64() - StartCycles;
+				GDbgLogStats.AddFired(*Callsite, FormatCycles, TotalCycles > FormatCycles ? TotalCycles - FormatCycles : 0);
+			}
+		}
+
+		UE_NONCOPYABLE(FDbgLogStatsScope);
+
+		bool IsActive() const { return Callsite != nullptr; }
+		void AddFormatCycles(uint64 Cycles) { FormatCycles += Cycles; }
+
+	private:
+		const FDbgLogCallsite* Callsite;
+		const uint64 StartCycles;
+		uint64 FormatCycles = 0;
+	};
+}
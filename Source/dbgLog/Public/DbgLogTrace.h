@@ -0,0 +1,81 @@
+// Copyright ©  Jack Holland.
+//
+// DbgLOG is free software. It comes without any warranty, to the extent permitted
+// by applicable law. You can redistribute it and/or modify it under the terms
+// of the Do What The Fuck You Want To Public License, Version 2, as published
+// by Sam Hocevar:
+//
+//            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+//                    Version 2, December 2004
+//
+// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+//
+// Everyone is permitted to copy and distribute verbatim or modified
+// copies of this license document, and changing it is allowed as long
+// as the name is changed.
+//
+//            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+//   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+//
+//  0. You just DO WHAT THE FUCK YOU WANT TO.
+#pragma once
+#include <atomic>
+
+#include "CoreMinimal.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Trace/Trace.h"
+
+
+#define DBGLOG_TRACE_ENABLED UE_TRACE_ENABLED
+
+#if DBGLOG_TRACE_ENABLED
+UE_TRACE_CHANNEL_EXTERN(dbgLogChannel, DBGLOG_API);
+
+// Shows up in Insights as "dbgLog::Name", costs a single channel check unless the trace was started with `-trace=dbgLog`.
+#define DBGLOG_TRACE_SCOPE(Name) TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("dbgLog::" #Name, dbgLogChannel)
+#define DBGLOG_TRACE_IS_ENABLED() UE_TRACE_CHANNELEXPR_IS_ENABLED(dbgLogChannel)
+#else
+#define DBGLOG_TRACE_SCOPE(Name)
+#define DBGLOG_TRACE_IS_ENABLED() false
+#endif
+
+
+namespace DBG::Log
+{
+	/**
+	 * What dbgLOG reports to Unreal Insights on the `dbgLogChannel` channel (`-trace=default,dbgLog`): CPU scopes around
+	 * the gate, the prefix, the formatting and every sink, a `dbgLog.Log` event per log carrying its callsite id (with a
+	 * `dbgLog.Callsite` event describing each callsite the first time it logs), and the logs per second, formatted bytes,
+	 * suppressed and dropped counters. The hot path only bumps relaxed atomics, the counters are published at the end of the frame.
+	 */
+	class DBGLOG_API FDbgLogTrace
+	{
+	public:
+		void StartupModule();
+		void ShutdownModule();
+
+		// All of these expect DBGLOG_TRACE_IS_ENABLED() to have been checked by the caller.
+		void CountSuppressed() { SuppressedCount.fetch_add(1, std::memory_order_relaxed); }
+		void CountFormattedBytes(int32 NumBytes) { FormattedBytes.fetch_add(NumBytes, std::memory_order_relaxed); }
+
+		// Emits the per log event, and the callsite description if bCallsiteDescribed wasn't set yet.
+		void TraceLog(uint64 CallsiteId, std::atomic<bool>& bCallsiteDescribed, const ANSICHAR* File, uint32 Line,
+			const FLogCategoryBase& Category, ELogVerbosity::Type Verbosity, uint64 Cycles);
+
+	private:
+		// Game thread, end of the frame.
+		void PublishCounters();
+
+		std::atomic<uint64> LogCount{0};
+		std::atomic<uint64> FormattedBytes{0};
+		std::atomic<uint64> SuppressedCount{0};
+
+		// LogCount the last time the logs per second were worked out.
+		uint64 RateLogCount = 0;
+		uint64 RateCycles = 0;
+
+		FDelegateHandle EndFrameHandle;
+	};
+
+	DBGLOG_API extern FDbgLogTrace GDbgLogTrace;
+}
@@ -0,0 +1,59 @@
+// Copyright ©  Jack Holland.
+//
+// DbgLOG is free software. It comes without any warranty, to the extent permitted
+// by applicable law. You can redistribute it and/or modify it under the terms
+// of the Do What The Fuck You Want To Public License, Version 2, as published
+// by Sam Hocevar:
+//
+//            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+//                    Version 2, December 2004
+//
+// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+//
+// Everyone is permitted to copy and distribute verbatim or modified
+// copies of this license document, and changing it is allowed as long
+// as the name is changed.
+//
+//            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+//   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+//
+//  0. You just DO WHAT THE FUCK YOU WANT TO.
+#pragma once
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Misc/StringBuilder.h"
+
+
+namespace DBG::Log
+{
+	/**
+	 * The `[Client | Instance: 0] ` prefix `.WCO()` adds, built once per world instead of for every log.
+	 * Entries are dropped when a world is initialized or cleaned up and rebuilt if the world's net mode changed.
+	 */
+	class DBGLOG_API FDbgLogWorldPrefixCache
+	{
+	public:
+		void StartupModule();
+		void ShutdownModule();
+
+		// Safe from any thread.
+		void AppendPrefix(FStringBuilderBase& Builder, const UWorld* World);
+
+	private:
+		void Invalidate(const UWorld* World);
+
+		struct FEntry
+		{
+			ENetMode NetMode = NM_MAX;
+			FString Prefix;
+		};
+
+		TMap<const UWorld*, FEntry> Entries;
+		FRWLock Lock;
+
+		FDelegateHandle PostWorldInitializationHandle;
+		FDelegateHandle WorldCleanupHandle;
+	};
+
+	DBGLOG_API extern FDbgLogWorldPrefixCache GDbgLogWorldPrefixCache;
+}
@@ -32,11 +32,14 @@
 #include <format>
 #include <source_location>
 #include <string>
+#include <string_view>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 #include <chrono>
 
 #include "Containers/StringConv.h"
+#include "Misc/StringBuilder.h"
 #include "Engine/Engine.h"
 #include "HAL/IConsoleManager.h"
 
@@ -61,6 +64,123 @@ namespace std
 
 
 
+namespace DBG::Log
+{
+	// Base for the UE string formatters below, writes a TCHAR range with the usual fill/align/width/precision specs.
+	struct FTCharRangeFormatter : std::formatter<std::wstring_view, wchar_t>
+	{
+		template<typename FormatContext>
+		auto FormatRange(const TCHAR* Data, int32 Len, FormatContext& Ctx) const
+		{
+			if constexpr (std::is_same_v<TCHAR, wchar_t>)
+			{
+				return std::formatter<std::wstring_view, wchar_t>::format(std::wstring_view(Data, Len), Ctx);
+			}
+			else
+			{
+				const auto Converted = StringCast<wchar_t>(Data, Len);
+				return std::formatter<std::wstring_view, wchar_t>::format(std::wstring_view(Converted.Get(), Converted.Length()), Ctx);
+			}
+		}
+	};
+
+	// Writes "(AActor*)BP_Foo_C_0", or "(AActor) Null Pointer" for null/invalid objects.
+	struct FObjectPointerFormatter : FTCharRangeFormatter
+	{
+		template<typename FormatContext>
+		auto FormatObject(const UObject* Object, const UClass* StaticType, FormatContext& Ctx) const
+		{
+			TStringBuilder<256> Builder;
+			if (::IsValid(Object))
+			{
+				Builder << TEXT("(") << Object->GetClass()->GetFName() << TEXT("*)") << Object->GetFName();
+			}
+			else
+			{
+				Builder << TEXT("(") << (Object ? Object->GetClass() : StaticType)->GetFName() << TEXT(") Null Pointer");
+			}
+			return FormatRange(Builder.GetData(), Builder.Len(), Ctx);
+		}
+	};
+}
+
+
+// The common UE types write straight into the format context, rather than going through FormatArgument's intermediate strings.
+template<>
+struct std::formatter<FString, wchar_t> : DBG::Log::FTCharRangeFormatter
+{
+	template<typename FormatContext>
+	auto format(const FString& Value, FormatContext& Ctx) const
+	{
+		return FormatRange(*Value, Value.Len(), Ctx);
+	}
+};
+
+template<>
+struct std::formatter<FStringView, wchar_t> : DBG::Log::FTCharRangeFormatter
+{
+	template<typename FormatContext>
+	auto format(FStringView Value, FormatContext& Ctx) const
+	{
+		return FormatRange(Value.GetData(), Value.Len(), Ctx);
+	}
+};
+
+template<>
+struct std::formatter<FName, wchar_t> : DBG::Log::FTCharRangeFormatter
+{
+	template<typename FormatContext>
+	auto format(const FName& Value, FormatContext& Ctx) const
+	{
+		TStringBuilder<FName::StringBufferSize> Builder;
+		Value.AppendString(Builder);
+		return FormatRange(Builder.GetData(), Builder.Len(), Ctx);
+	}
+};
+
+template<>
+struct std::formatter<FText, wchar_t> : DBG::Log::FTCharRangeFormatter
+{
+	template<typename FormatContext>
+	auto format(const FText& Value, FormatContext& Ctx) const
+	{
+		const FString& String = Value.ToString();
+		return FormatRange(*String, String.Len(), Ctx);
+	}
+};
+
+template<typename T> requires std::derived_from<std::remove_const_t<T>, UObject>
+struct std::formatter<T*, wchar_t> : DBG::Log::FObjectPointerFormatter
+{
+	template<typename FormatContext>
+	auto format(const T* Value, FormatContext& Ctx) const
+	{
+		return FormatObject(Value, std::remove_const_t<T>::StaticClass(), Ctx);
+	}
+};
+
+template<typename T>
+struct std::formatter<TObjectPtr<T>, wchar_t> : DBG::Log::FObjectPointerFormatter
+{
+	template<typename FormatContext>
+	auto format(const TObjectPtr<T>& Value, FormatContext& Ctx) const
+	{
+		return FormatObject(Value.Get(), std::remove_const_t<T>::StaticClass(), Ctx);
+	}
+};
+
+template<typename T>
+struct std::formatter<TWeakObjectPtr<T>, wchar_t> : DBG::Log::FObjectPointerFormatter
+{
+	template<typename FormatContext>
+	auto format(const TWeakObjectPtr<T>& Value, FormatContext& Ctx) const
+	{
+		return FormatObject(Value.Get(), std::remove_const_t<T>::StaticClass(), Ctx);
+	}
+};
+
+
+
 namespace DBG::Log
 {
 	template<typename T>
@@ -82,8 +202,41 @@ namespace DBG::Log
 	template<typename T>
 	concept TIterable = requires(T t) { t.begin().operator++(); t.end(); t.begin() != t.end(); };
 
+	// Types that FormatArgument turns into an FString before it would consider treating them as a container.
 	template<typename T>
-	auto FormatArgument(T&& Value)
+	concept THasStringConversion = requires(T&& Value) { Value->GetName(); } || requires(T&& Value) { Value.GetName(); }
+								 || requires(T&& Value) { Value->ToString(); } || requires(T&& Value) { Value.ToString(); }
+								 || requires(T&& Value) { Value->c_str(); } || requires(T&& Value) { Value.c_str(); }
+								 || requires { std::remove_pointer_t<std::remove_reference_t<T>>::StaticStruct(); }
+								 || std::is_assignable_v<FString, T> || std::is_convertible_v<T, FName>
+								 || requires(T&& Value) { LexToString(std::forward<T>(Value)); };
+
+	template<typename T>
+	concept TFormatsAsRange = !THasStringConversion<T> && (std::is_array_v<std::remove_reference_t<T>> || TIterable<T>);
+
+	template<typename T>
+	concept TFormatsAsTuple = !THasStringConversion<T> && !TFormatsAsRange<T>
+							  && (TIsTuple_V<std::decay_t<T>> || requires { std::tuple_size_v<std::decay_t<T>>; });
+
+	/**
+	 * What FormatArgument hands std::format for containers and tuples, the formatters below stream the elements straight
+	 * into the output. `{:n=32}` caps how many elements are printed, `dbgLog.MaxContainerElements` is the default cap.
+	 */
+	template<typename T>
+	struct TFormatRange
+	{
+		T& Range;
+	};
+
+	template<typename T>
+	struct TFormatTuple
+	{
+		T& Tuple;
+	};
+
+	// Types std::format handles are passed through as references, everything else comes back as a std::wstring.
+	template<typename T>
+	decltype(auto) FormatArgument(T&& Value)
 	{
 		using UnderlyingType = std::remove_pointer_t<std::remove_reference_t<T>>;
 		constexpr bool bIsPointer = std::is_pointer_v<std::remove_cvref_t<decltype(Value)>>;
@@ -97,7 +250,15 @@ namespace DBG::Log
 		// Everything that std::format can handle goes straight through
 		else if constexpr (THasStdFormat<T>)
 		{
-			return Value;
+			return std::forward<T>(Value);
+		}
+		else if constexpr (TFormatsAsRange<T>)
+		{
+			return TFormatRange<std::remove_reference_t<T>>{Value};
+		}
+		else if constexpr (TFormatsAsTuple<T>)
+		{
+			return TFormatTuple<std::remove_reference_t<T>>{Value};
 		}
 		else
 		{
@@ -217,99 +378,217 @@ namespace DBG::Log
 			{
 				Str = FName(std::forward<T>(Value)).ToString();
 			}
-			else if constexpr (std::is_array_v<std::remove_reference_t<T>>) // compile time c arrays
-			{
-				Str = TEXT("[");
-				for (auto&& Elem : Value)
-				{
-					Str += std::format(TEXT("{}, "), FormatArgument(std::forward<decltype(Elem)>(Elem))).c_str();
-				}
-				Str.LeftChopInline(2);
-				Str += TEXT("]");
-			}
 			else if constexpr (requires { LexToString(std::forward<T>(Value)); })
 			{
 				Str = LexToString(std::forward<T>(Value));
 			}
-			else if constexpr (TIterable<T>) // Collections
+			// else if constexpr (your stuff goes here) { }
+			else
 			{
-				Str = TEXT("[");
-				for (auto&& i : std::forward<T>(Value))
+				static_assert(TFalse<T>, "Unhandled type");
+			}
+	
+			// Attach extra type info to UObjects (UObject*& counts as a pointer)
+			if (UType)
+			{
+				Str = TEXT("(") + UType->GetName() +
+						(std::is_pointer_v<V> ? TEXT("*)") : TEXT("&)"))
+						+ Str;
+			}
+
+			
+			return std::wstring( StringCast<wchar_t>(*Str).Get() );
+		}
+	}
+
+
+	// What std::format deduces its argument types as for the result of FormatArgument, so the format strings line up.
+	template<typename T>
+	using TFormatted = std::conditional_t<std::is_rvalue_reference_v<decltype(FormatArgument(std::declval<T>()))>,
+						   std::remove_reference_t<decltype(FormatArgument(std::declval<T>()))>,
+						   decltype(FormatArgument(std::declval<T>()))>;
+
+	// The raw format string, the MSSTL versions patched above only expose it as _Str.
+	template<typename F>
+	constexpr std::wstring_view GetFormatString(const F& Format)
+	{
+		if constexpr (requires { Format.get(); })
+		{
+			return Format.get();
+		}
+		else
+		{
+			return Format._Str;
+		}
+	}
+
+
+	// 0 means no limit, see `dbgLog.MaxContainerElements`.
+	DBGLOG_API extern int32 GDbgLogMaxContainerElements;
+
+	// Not constexpr on purpose, reaching it while the format string is checked at compile time makes the bad spec a compile error.
+	inline void InvalidContainerFormatSpec()
+	{
+		ensureMsgf(false, TEXT("Invalid container format spec, expected nothing or \"n=<count>\"."));
+	}
+
+	// Shared by the container and tuple formatters, parses `{:n=32}` and writes the elements with the limit applied.
+	struct FContainerFormatter
+	{
+		constexpr auto parse(std::wformat_parse_context& Ctx)
+		{
+			auto It = Ctx.begin();
+			const auto End = Ctx.end();
+			if (It != End && *It == L'n')
+			{
+				++It;
+				int64 Count = -1;
+				if (It != End && *It == L'=')
 				{
-					Str += std::format(TEXT("{}, "), FormatArgument(std::forward<decltype(i)>(i))).c_str();
+					for (++It; It != End && *It >= L'0' && *It <= L'9'; ++It)
+					{
+						Count = (Count < 0 ? 0 : Count) * 10 + (*It - L'0');
+						Count = Count > MAX_int32 ? MAX_int32 : Count;
+					}
 				}
-				
-				if (Str.Len() > 1)
+
+				if (Count < 0)
 				{
-					Str.LeftChopInline(2);
+					InvalidContainerFormatSpec();
 				}
 				else
 				{
-					Str += TEXT(" Empty ");
+					MaxElements = static_cast<int32>(Count);
 				}
-				
-				Str += TEXT("]");
 			}
-			else if constexpr (TIsTuple_V<V>)
+
+			if (It != End && *It != L'}')
 			{
-				Str = TEXT("{");
-				std::forward<T>(Value).ApplyBefore([&Str]<typename... A>(A&&... Args)
-				{
-					((Str += std::format(TEXT("{}, "), FormatArgument(std::forward<A>(Args))).c_str()), ...);
-				});
-				
-				if (Str.Len() > 1)
-				{
-					Str.LeftChopInline(2);
-				}
-				else
+				InvalidContainerFormatSpec();
+				while (It != End && *It != L'}')
 				{
-					Str += TEXT(" Empty ");
+					++It;
 				}
-				
-				Str += TEXT("}");
 			}
-			else if constexpr (requires { std::tuple_size_v<V>; })
-			{
-				Str = TEXT("{");
-				std::apply([&Str]<typename... A>(A&&... args)
-				{
-					((Str += std::format(L"{}, ", FormatArgument(std::forward<A>(args))).c_str()), ...);
-				}, std::forward<T>(Value));
+			return It;
+		}
 
-				if (Str.Len() > 1)
+	protected:
+		// Calls Visit(WriteElement) once, Visit feeds every element to WriteElement and Num is -1 if the count isn't known up front.
+		template<typename FormatContext, typename VisitFunc>
+		auto FormatElements(FormatContext& Ctx, wchar_t Open, wchar_t Close, int64 Num, VisitFunc&& Visit) const
+		{
+			const int32 Limit = MaxElements >= 0 ? MaxElements : GDbgLogMaxContainerElements;
+
+			auto Out = Ctx.out();
+			*Out++ = Open;
+
+			int32 NumPrinted = 0;
+			int64 NumSkipped = 0;
+			Visit([&](auto&& Element)
+			{
+				if (Limit > 0 && NumPrinted == Limit)
 				{
-					Str.LeftChopInline(2);
+					++NumSkipped;
+					return Num < 0; // Keep counting only if we have to.
 				}
-				else
+
+				if (NumPrinted++ > 0)
 				{
-					Str += TEXT(" Empty ");
+					*Out++ = L',';
+					*Out++ = L' ';
 				}
-				
-				Str += TEXT("}");
+				Out = std::format_to(Out, L"{}", FormatArgument(std::forward<decltype(Element)>(Element)));
+				return true;
+			});
+
+			if (NumPrinted == 0)
+			{
+				Out = std::format_to(Out, L" Empty ");
 			}
-			// else if constexpr (your stuff goes here) { }
-			else
+			else if (NumSkipped > 0)
 			{
-				static_assert(TFalse<T>, "Unhandled type");
+				Out = std::format_to(Out, L", ... (+{} more)", Num < 0 ? NumSkipped : Num - NumPrinted);
 			}
-	
-			// Attach extra type info to UObjects (UObject*& counts as a pointer)
-			if (UType)
+
+			*Out++ = Close;
+			return Out;
+		}
+
+		// Negative until a spec sets it, then the cvar is used.
+		int32 MaxElements = -1;
+	};
+}
+
+
+template<typename T>
+struct std::formatter<DBG::Log::TFormatRange<T>, wchar_t> : DBG::Log::FContainerFormatter
+{
+	template<typename FormatContext>
+	auto format(const DBG::Log::TFormatRange<T>& Value, FormatContext& Ctx) const
+	{
+		int64 Num = -1;
+		if constexpr (requires { Value.Range.Num(); })
+		{
+			Num = Value.Range.Num();
+		}
+		else if constexpr (requires { std::size(Value.Range); })
+		{
+			Num = static_cast<int64>(std::size(Value.Range));
+		}
+
+		return FormatElements(Ctx, L'[', L']', Num, [&Value](auto&& WriteElement)
+		{
+			for (auto&& Element : Value.Range)
 			{
-				Str = TEXT("(") + UType->GetName() +
-						(std::is_pointer_v<V> ? TEXT("*)") : TEXT("&)"))
-						+ Str;
+				if (WriteElement(std::forward<decltype(Element)>(Element)) == false)
+				{
+					break;
+				}
 			}
+		});
+	}
+};
 
-			
-			return std::wstring( StringCast<wchar_t>(*Str).Get() );
+template<typename T>
+struct std::formatter<DBG::Log::TFormatTuple<T>, wchar_t> : DBG::Log::FContainerFormatter
+{
+	template<typename FormatContext>
+	auto format(const DBG::Log::TFormatTuple<T>& Value, FormatContext& Ctx) const
+	{
+		int64 Num = 0;
+		if constexpr (TIsTuple_V<std::decay_t<T>>)
+		{
+			Num = TTupleArity<std::decay_t<T>>::Value;
+		}
+		else
+		{
+			Num = std::tuple_size_v<std::decay_t<T>>;
 		}
+
+		return FormatElements(Ctx, L'{', L'}', Num, [&Value](auto&& WriteElement)
+		{
+			auto WriteAll = [&WriteElement]<typename... A>(A&&... Elements)
+			{
+				// Tuples are never big enough for stopping early to be worth it.
+				(WriteElement(std::forward<A>(Elements)), ...);
+			};
+
+			if constexpr (TIsTuple_V<std::decay_t<T>>)
+			{
+				Value.Tuple.ApplyBefore(WriteAll);
+			}
+			else
+			{
+				std::apply(WriteAll, Value.Tuple);
+			}
+		});
 	}
+};
 
 
-	template<typename T>
-	using TFormatted = decltype(FormatArgument(std::declval<T>()));
+namespace DBG::Log
+{
 
 	
 	template<typename... A>
@@ -317,6 +596,97 @@ namespace DBG::Log
 	{
 		return FString( std::format(std::move(Format), FormatArgument(std::forward<A>(Args))...).c_str() );
 	}
+
+
+	// Lets std::format_to write straight into a string builder.
+	class FStringBuilderAppendIterator
+	{
+	public:
+		using iterator_category = std::output_iterator_tag;
+		using value_type		= void;
+		using difference_type	= std::ptrdiff_t;
+		using pointer			= void;
+		using reference			= void;
+
+		explicit FStringBuilderAppendIterator(FStringBuilderBase& InBuilder) : Builder(&InBuilder) {}
+
+		FStringBuilderAppendIterator& operator=(wchar_t Char)
+		{
+			Builder->AppendChar(static_cast<TCHAR>(Char));
+			return *this;
+		}
+
+		FStringBuilderAppendIterator& operator*() { return *this; }
+		FStringBuilderAppendIterator& operator++() { return *this; }
+		FStringBuilderAppendIterator operator++(int) { return *this; }
+
+	private:
+		FStringBuilderBase* Builder;
+	};
+
+	// Same as FormatMessage, but appends to Out rather than going through a std::wstring and a new FString.
+	template<typename... A>
+	void FormatMessageTo(FStringBuilderBase& Out, std::wformat_string<TFormatted<A>...> Format, A&&... Args)
+	{
+		std::format_to(FStringBuilderAppendIterator(Out), std::move(Format), FormatArgument(std::forward<A>(Args))...);
+	}
+
+
+
+	/**
+	 * Whether an argument can be captured as raw bytes and run through FormatArgument later on another thread
+	 * (see FDbgLogAsyncBackend). Only types that are trivial to copy and don't point into memory that could be gone
+	 * by then belong here, specialize it for your own types if they fit that description.
+	 */
+	template<typename T>
+	struct TCanDeferFormat
+	{
+		static constexpr bool Value = std::is_arithmetic_v<T> || std::is_enum_v<T>;
+	};
+
+	template<> struct TCanDeferFormat<FName> { static constexpr bool Value = true; };
+	template<> struct TCanDeferFormat<FColor> { static constexpr bool Value = true; };
+	template<> struct TCanDeferFormat<FLinearColor> { static constexpr bool Value = true; };
+	template<typename T> struct TCanDeferFormat<TEnumAsByte<T>> { static constexpr bool Value = true; };
+	template<typename T> struct TCanDeferFormat<UE::Math::TVector<T>> { static constexpr bool Value = true; };
+	template<typename T> struct TCanDeferFormat<UE::Math::TVector2<T>> { static constexpr bool Value = true; };
+	template<typename T> struct TCanDeferFormat<UE::Math::TVector4<T>> { static constexpr bool Value = true; };
+	template<typename T> struct TCanDeferFormat<UE::Math::TRotator<T>> { static constexpr bool Value = true; };
+	template<typename T> struct TCanDeferFormat<UE::Math::TQuat<T>> { static constexpr bool Value = true; };
+	template<typename T> struct TCanDeferFormat<UE::Math::TIntPoint<T>> { static constexpr bool Value = true; };
+	template<typename T> struct TCanDeferFormat<UE::Math::TIntVector3<T>> { static constexpr bool Value = true; };
+
+	template<typename T>
+	concept TDeferrableArgument = TCanDeferFormat<std::remove_cvref_t<T>>::Value
+								  && std::is_trivially_copyable_v<std::remove_cvref_t<T>>;
+
+	// The raw arguments as they are stored in a deferred record.
+	template<typename... A>
+	using TDeferredArguments = std::tuple<std::remove_cvref_t<A>...>;
+
+	// Appends the message made from the captured arguments to OutMessage.
+	using FDeferredFormatFunc = void(*)(std::wstring_view Format, const uint8* ArgData, FString& OutMessage);
+
+	template<typename... A>
+	void FormatDeferredMessage(std::wstring_view Format, const uint8* ArgData, FString& OutMessage)
+	{
+		using FArguments = TDeferredArguments<A...>;
+
+		// The record's buffer makes no alignment promises, so copy the arguments back out first.
+		alignas(FArguments) uint8 Storage[sizeof(FArguments)];
+		FMemory::Memcpy(Storage, ArgData, sizeof(FArguments));
+		const FArguments& Arguments = *reinterpret_cast<const FArguments*>(Storage);
+
+		std::apply([&](const auto&... Values)
+		{
+			// The format string was already validated against these types at the callsite.
+			auto Formatted = std::make_tuple(FormatArgument(Values)...);
+			std::apply([&](auto&... FormattedValues)
+			{
+				OutMessage += std::vformat(Format, std::make_wformat_args(FormattedValues...)).c_str();
+			}, Formatted);
+		}, Arguments);
+	}
 }
 
 
@@ -19,7 +19,22 @@
 //
 //  0. You just DO WHAT THE FUCK YOU WANT TO.
 #pragma once
+#include <array>
+#include <atomic>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
 #include "LLog.h"
+#include "DbgLogAsync.h"
+#include "DbgLogBinary.h"
+#include "DbgLogDebugDraw.h"
+#include "DbgLogGameThread.h"
+#include "DbgLogScreen.h"
+#include "DbgLogStats.h"
+#include "DbgLogTrace.h"
+#include "DbgLogWorldPrefix.h"
+#include "Hash/CityHash.h"
 #include "VisualLogger/VisualLogger.h"
 #include "Misc/EngineVersionComparison.h"
 #include "Framework/Notifications/NotificationManager.h"
@@ -32,6 +47,31 @@
 
 #define KEEP_DBG_LOG (!UE_BUILD_SHIPPING) || (USE_LOGGING_IN_SHIPPING)
 
+/**
+ * The most verbose level that `dbgLOGCT` callsites are compiled in for, anything more verbose is stripped out
+ * entirely (arguments and all), the same way `COMPILED_IN_MINIMUM_VERBOSITY` works for UE_LOG.
+ * Runtime verbosities above it (IE `dbgLOGV(.Verbose(), ...)`) are also rejected by the gate before formatting.
+ * Takes a bare verbosity name, for example `PublicDefinitions.Add("DBG_LOG_COMPILE_MIN_VERBOSITY=Log");`
+ */
+#ifndef DBG_LOG_COMPILE_MIN_VERBOSITY
+	#define DBG_LOG_COMPILE_MIN_VERBOSITY VeryVerbose
+#endif
+
+// Preprocessor friendly values of ELogVerbosity, so we can compare them inside of #if.
+#define DBG_LOG_VERBOSITY_NoLogging		0
+#define DBG_LOG_VERBOSITY_Fatal			1
+#define DBG_LOG_VERBOSITY_Error			2
+#define DBG_LOG_VERBOSITY_Warning		3
+#define DBG_LOG_VERBOSITY_Display		4
+#define DBG_LOG_VERBOSITY_Log			5
+#define DBG_LOG_VERBOSITY_Verbose		6
+#define DBG_LOG_VERBOSITY_VeryVerbose	7
+#define DBG_LOG_VERBOSITY_All			7
+
+#define _DBG_LOG_VERBOSITY_VALUE(Verbosity) DBG_LOG_VERBOSITY_##Verbosity
+#define DBG_LOG_VERBOSITY_VALUE(Verbosity) _DBG_LOG_VERBOSITY_VALUE(Verbosity)
+#define DBG_LOG_COMPILED_IN_VERBOSITY DBG_LOG_VERBOSITY_VALUE(DBG_LOG_COMPILE_MIN_VERBOSITY)
+
 // #define DBG_API MYMODULE_API // If you would rather define the modules API here you can, but otherwise stick to using the build.cs definition.
 
 
@@ -67,6 +107,9 @@
  *	- `dbgLOG`
  *	- `dbgLOGV`.
  *
+ *	If you want verbose logs to vanish from certain builds entirely there is also `dbgLOGCT(Verbose, .Builder(), "Msg")`
+ *	which takes the verbosity at compile time and strips anything above `DBG_LOG_COMPILE_MIN_VERBOSITY`.
+ *
  *
  *	Side note: You can easily redefine these macros to fit your own projects naming scheme by simply copy pasting this and renaming it to your own preference:
  *	#define MYOWNLOG(Msg, ...) dbgLOG(Msg, __VA_ARGS__)
@@ -78,7 +121,10 @@
  *  "dbgLog.PrintCategoriesStates" Can be used to print the current state of the categories registered with us.
  *
  *  These are built ON TOP of the existing verbosity system in unreal and are just a nice thing to have for quick enabling/disabling
- *  without modifying a logs verbosity directly. Now onto explaining the rest.
+ *  without modifying a logs verbosity directly.
+ *
+ *  "dbgLog.Async 1" (or launching with -dbgLogAsync) moves writing console logs onto a background thread, and
+ *  "dbgLog.Flush" blocks until everything queued up so far has been written. Now onto explaining the rest.
  *
  *
  *	dbgLOG is your standard log macro that takes a format message and optional logs, some example usages are as follows:
@@ -233,6 +279,16 @@
  *	dbgLOGV(.Condition(false), "I only log if the condition is true");
  *
  *
+ *	// Rate limiting for callsites in Tick and friends, all of these are per callsite and checked before any formatting happens.
+ *	// The first log after some were skipped is prefixed with "(suppressed N messages)".
+ *	dbgLOGV(.Once(), "I only ever log the first time");
+ *	dbgLOGV(.EveryN(60), "I log every 60th call");
+ *	dbgLOGV(.Throttle(2.f), "I log at most twice a second");
+ *
+ *	// Only logs when the watched values changed since the previous call, the check is a hash compare so nothing gets formatted otherwise.
+ *	dbgLOGV(.OnChange(Health, State), "Health: {0}, State: {1}", Health, State);
+ *
+ *
  *
  *	// Spawns a slate notification popup in the bottom right - the verbosity of the log dictates the notify show duration.
  *	dbgLOGV(.LogToSlateNotify(), "My Slate Notify"); // Shows for 6s
@@ -288,13 +344,29 @@ DBGLOG_API DECLARE_LOG_CATEGORY_EXTERN(dbgLOG, Display, All);
 
 
 // Should not be used directly.
+// The format arguments are only evaluated once `ShouldLog` passes, so suppressed logs never pay for them.
 #define _INTERNAL_DBGLOGV(Args, Msg, Name, ...) do\
 {\
+    static DBG::Log::FDbgLogCallsite _CONCAT(Name, Site){std::source_location::current()}; \
     DBG::Log::DbgLogArgs Name{}; \
     Name Args;\
-    DBG::Log::Log(__COUNTER__, std::source_location::current(), Name,  TEXT(Msg) __VA_OPT__(,) __VA_ARGS__); \
+    if (Name.ShouldLog(_CONCAT(Name, Site)))\
+    {\
+        DBG::Log::Log(_CONCAT(Name, Site), Name,  TEXT(Msg) __VA_OPT__(,) __VA_ARGS__); \
+    }\
 } while(false)
 
+// Should not be used directly.
+#define _INTERNAL_DBGLOG(Msg, Name, ...) do\
+{\
+    static DBG::Log::FDbgLogCallsite _CONCAT(Name, Site){std::source_location::current()}; \
+    DBG::Log::DbgLogArgs Name{}; \
+    if (Name.ShouldLog(_CONCAT(Name, Site)))\
+    {\
+        DBG::Log::Log(_CONCAT(Name, Site), Name, TEXT(Msg) __VA_OPT__(,) __VA_ARGS__);\
+    }\
+}while(false)
+
 
 /**
  *	This your standard formatted log message, could either be `"Hello World" or "Hello World {0}" where 0 is placement
@@ -312,10 +384,7 @@ DBGLOG_API DECLARE_LOG_CATEGORY_EXTERN(dbgLOG, Display, All);
  * dbgLOG("Hello World {0:.3f}", 3.1415926535);
  * \endcode
  */
-#define dbgLOG(Msg, ...) do\
-{\
-    DBG::Log::Log(__COUNTER__, std::source_location::current(), DBG::Log::DbgLogArgs{}, TEXT(Msg) __VA_OPT__(,) __VA_ARGS__);\
-}while(false)
+#define dbgLOG(Msg, ...) _INTERNAL_DBGLOG(Msg, _CONCAT(LogArgs, __COUNTER__) __VA_OPT__(,) __VA_ARGS__)
 
 
 /**
@@ -346,24 +415,338 @@ DBGLOG_API DECLARE_LOG_CATEGORY_EXTERN(dbgLOG, Display, All);
 #define dbgLOGV(Args, Msg, ...) _INTERNAL_DBGLOGV(Args, Msg, _CONCAT(LogArgs, __COUNTER__) __VA_OPT__(,) __VA_ARGS__)
 
 
+/**
+ * Same as `dbgLOGV` but the verbosity is given at compile time as a bare name (like UE_LOG), which allows the whole
+ * callsite to be stripped when it is more verbose than `DBG_LOG_COMPILE_MIN_VERBOSITY`, including the evaluation
+ * of its arguments and the `Log` instantiation. The builder args can be left empty.
+ *
+ * \code
+ * // Compiled out entirely when DBG_LOG_COMPILE_MIN_VERBOSITY is `Log` or lower.
+ * dbgLOGCT(Verbose, .Category("AI"), "Picked target {0}", Target);
+ * dbgLOGCT(VeryVerbose, , "Tick {0}", DeltaTime);
+ * \endcode
+ */
+#define dbgLOGCT(Verb, Args, Msg, ...) _CONCAT(_INTERNAL_DBGLOGCT_, Verb)(.Verbosity(ELogVerbosity::Verb) Args, Msg, _CONCAT(LogArgs, __COUNTER__) __VA_OPT__(,) __VA_ARGS__)
+
+// Should not be used directly, one per verbosity so the preprocessor can throw away what is not compiled in.
+#define _INTERNAL_DBGLOGCT_NoLogging(...)
+#define _INTERNAL_DBGLOGCT_Fatal(...) _INTERNAL_DBGLOGV(__VA_ARGS__)
+
+#if DBG_LOG_COMPILED_IN_VERBOSITY >= DBG_LOG_VERBOSITY_Error
+	#define _INTERNAL_DBGLOGCT_Error(...) _INTERNAL_DBGLOGV(__VA_ARGS__)
+#else
+	#define _INTERNAL_DBGLOGCT_Error(...)
+#endif
+
+#if DBG_LOG_COMPILED_IN_VERBOSITY >= DBG_LOG_VERBOSITY_Warning
+	#define _INTERNAL_DBGLOGCT_Warning(...) _INTERNAL_DBGLOGV(__VA_ARGS__)
+#else
+	#define _INTERNAL_DBGLOGCT_Warning(...)
+#endif
+
+#if DBG_LOG_COMPILED_IN_VERBOSITY >= DBG_LOG_VERBOSITY_Display
+	#define _INTERNAL_DBGLOGCT_Display(...) _INTERNAL_DBGLOGV(__VA_ARGS__)
+#else
+	#define _INTERNAL_DBGLOGCT_Display(...)
+#endif
+
+#if DBG_LOG_COMPILED_IN_VERBOSITY >= DBG_LOG_VERBOSITY_Log
+	#define _INTERNAL_DBGLOGCT_Log(...) _INTERNAL_DBGLOGV(__VA_ARGS__)
+#else
+	#define _INTERNAL_DBGLOGCT_Log(...)
+#endif
+
+#if DBG_LOG_COMPILED_IN_VERBOSITY >= DBG_LOG_VERBOSITY_Verbose
+	#define _INTERNAL_DBGLOGCT_Verbose(...) _INTERNAL_DBGLOGV(__VA_ARGS__)
+#else
+	#define _INTERNAL_DBGLOGCT_Verbose(...)
+#endif
+
+#if DBG_LOG_COMPILED_IN_VERBOSITY >= DBG_LOG_VERBOSITY_VeryVerbose
+	#define _INTERNAL_DBGLOGCT_VeryVerbose(...) _INTERNAL_DBGLOGV(__VA_ARGS__)
+#else
+	#define _INTERNAL_DBGLOGCT_VeryVerbose(...)
+#endif
+
+
 
 
 
 namespace DBG::Log
 {
+	/**
+	 * A category resolved from a user provided name, immutable once handed out and never freed, which is what
+	 * lets the callsites cache a pointer to it without any locking.
+	 */
+	struct FDbgLogCategoryHandle
+	{
+		// Address of the string literal this handle was requested with, if that's how it was requested.
+		const ANSICHAR* Literal = nullptr;
+
+		// The existing category this handle was requested with, if that's how it was requested.
+		const FLogCategoryBase* Existing = nullptr;
+
+		// The name as the user provided it (without the `dbg` prefix), or the name of the existing category.
+		FName Name;
+
+		const FLogCategoryBase* Category = nullptr;
+
+		// Dense id into the FDbgLogSingleton state table.
+		int32 StateId = INDEX_NONE;
+	};
+
+
+	/**
+	 * Owns every category created at runtime through `.Category("Foo")`, each one is created (and registered with
+	 * the log suppression system) exactly once and lives until shutdown.
+	 */
+	struct DBGLOG_API FDbgLogCategoryRegistry
+	{
+		static FDbgLogCategoryRegistry& Get();
+
+		// Returns the handle for the category `dbg<CategoryName>`, creating it if needed (None and `dbgLOG` map onto dbgLOG).
+		const FDbgLogCategoryHandle* FindOrAdd(FName CategoryName);
+
+		// Same as above but keyed by the address of a string literal, so repeated lookups do not need to build an FName.
+		const FDbgLogCategoryHandle* FindOrAdd(const ANSICHAR* CategoryLiteral);
+
+		// Returns the handle for a category that already exists (IE `LogTemp` or `dbgLOG`).
+		const FDbgLogCategoryHandle* FindOrAdd(const FLogCategoryBase& ExistingCategory);
+
+	private:
+		const FDbgLogCategoryHandle* FindOrAddNameHandle_Locked(FName CategoryName);
+
+		using FDbgLogDynamicCategory = FLogCategory<ELogVerbosity::Display, ELogVerbosity::All>;
+
+		FCriticalSection Lock;
+		TMap<FName, TUniquePtr<FDbgLogDynamicCategory>> Categories;
+		TMap<FName, TUniquePtr<FDbgLogCategoryHandle>> NameHandles;
+		TMap<const ANSICHAR*, TUniquePtr<FDbgLogCategoryHandle>> LiteralHandles;
+		TMap<const FLogCategoryBase*, TUniquePtr<FDbgLogCategoryHandle>> ExistingHandles;
+	};
+
+
+	// Everything after the last path separator.
+	constexpr std::string_view GetCleanFileName(std::string_view Path)
+	{
+		const size_t Separator = Path.find_last_of("/\\");
+		return Separator == std::string_view::npos ? Path : Path.substr(Separator + 1);
+	}
+
+	// The " __cdecl" MSVC puts in function names, which only adds noise to the log.
+	inline constexpr std::string_view CallingConvention = " __cdecl";
+
+	// The function name around its first " __cdecl". The tail may hold more of them (function pointer parameters, lambdas),
+	// which AppendSourceLocation strips as it goes.
+	constexpr std::array<std::string_view, 2> SplitFunctionName(std::string_view FunctionName)
+	{
+		const size_t Found = FunctionName.find(CallingConvention);
+		if (Found == std::string_view::npos)
+		{
+			return {FunctionName, std::string_view{}};
+		}
+		return {FunctionName.substr(0, Found), FunctionName.substr(Found + CallingConvention.size())};
+	}
+
+
+	// FNV-1a, constexpr so a callsite's identity is hashed at compile time.
+	constexpr uint64 HashCallsiteValue(uint64 Hash, std::string_view Value)
+	{
+		for (const char Char : Value)
+		{
+			Hash = (Hash ^ static_cast<uint8>(Char)) * 0x100000001b3ull;
+		}
+		return Hash;
+	}
+
+	constexpr uint64 HashCallsiteValue(uint64 Hash, uint64 Value)
+	{
+		for (int32 Byte = 0; Byte < 8; ++Byte, Value >>= 8)
+		{
+			Hash = (Hash ^ (Value & 0xff)) * 0x100000001b3ull;
+		}
+		return Hash;
+	}
+
+	// Same for every build of the same source, unlike __COUNTER__ which is only unique within a translation unit.
+	constexpr uint64 HashCallsite(const std::source_location& Location)
+	{
+		uint64 Hash = HashCallsiteValue(0xcbf29ce484222325ull, Location.file_name());
+		Hash = HashCallsiteValue(Hash, (static_cast<uint64>(Location.line()) << 32) | Location.column());
+		return HashCallsiteValue(Hash, Location.function_name());
+	}
+
+
+	/**
+	 * Per callsite state, the macros create one of these as a function local static so anything kept in here
+	 * is paid for once per callsite rather than once per call.
+	 */
+	struct FDbgLogCallsite
+	{
+		using FLogRecord = ::UE::Logging::Private::FStaticBasicLogRecord;
+
+		explicit constexpr FDbgLogCallsite(std::source_location InLocation)
+			: Location(InLocation)
+			, CleanFileName(GetCleanFileName(InLocation.file_name()))
+			, FunctionNameParts(SplitFunctionName(InLocation.function_name()))
+			, Hash(HashCallsite(InLocation))
+			, LogRecords(MakeLogRecords(InLocation, LogDynamic, std::make_index_sequence<NumLogRecords>()))
+		{
+		}
+
+		// The record handed to GLog for this verbosity (flags included), never written to so any thread can use it.
+		const FLogRecord& GetLogRecord(ELogVerbosity::Type Verbosity) const
+		{
+			return LogRecords[GetLogRecordIndex(Verbosity)];
+		}
+
+		// Hands an async record the same log record the synchronous path would have used.
+		void SetLogRecord(FDbgLogRecord& Record) const
+		{
+			Record.LogRecord = &GetLogRecord(Record.Verbosity);
+		}
+
+		// Appends "[File: Foo.cpp (42), void AFoo::Bar(void)]" without any allocations.
+		void AppendSourceLocation(FStringBuilderBase& Builder) const
+		{
+			Builder << TEXT("[File: ");
+			Builder.Append(CleanFileName.data(), static_cast<int32>(CleanFileName.size()));
+			Builder.Appendf(TEXT(" (%u), "), Location.line());
+			Builder.Append(FunctionNameParts[0].data(), static_cast<int32>(FunctionNameParts[0].size()));
+			std::string_view Rest = FunctionNameParts[1];
+			for (size_t Found = Rest.find(CallingConvention); Found != std::string_view::npos; Found = Rest.find(CallingConvention))
+			{
+				Builder.Append(Rest.data(), static_cast<int32>(Found));
+				Rest.remove_prefix(Found + CallingConvention.size());
+			}
+			Builder.Append(Rest.data(), static_cast<int32>(Rest.size()));
+			Builder << TEXT("]");
+		}
+
+		const std::source_location Location;
+
+		// Sliced out of Location when the callsite is constant initialized, so they cost nothing at runtime.
+		const std::string_view CleanFileName;
+		const std::array<std::string_view, 2> FunctionNameParts;
+
+		// Stable hash of the file, line, column and function, used as the screen message key.
+		const uint64 Hash;
+
+		// One record for every verbosity and SetColor/BreakOnLog combination since the verbosity is only known at runtime.
+		// BasicLog registers each record once through its dynamic data, so every record needs its own.
+		static constexpr size_t NumLogRecords = ELogVerbosity::NumVerbosity * 4;
+
+		// What UE_LOG would have made for this callsite, LogDynamic has to be declared first as the records keep a reference to it.
+		std::array<::UE::Logging::Private::FStaticBasicLogDynamicData, NumLogRecords> LogDynamic;
+		const std::array<FLogRecord, NumLogRecords> LogRecords;
+
+		// Last category handle this callsite resolved to, a single pointer load on every call after the first.
+		std::atomic<const FDbgLogCategoryHandle*> CachedCategory{nullptr};
+
+		// Id in the current binary log file (see FDbgLogBinarySink), zero until this callsite first writes to one.
+		std::atomic<uint64> BinaryId{0};
+
+		// Hash of the `.OnChange()` values from the last call, zero until there was one.
+		std::atomic<uint64> OnChangeHash{0};
+
+		// State for `.Once()`, `.EveryN()` and `.Throttle()`.
+		std::atomic<uint32> RateLimitCalls{0};
+		std::atomic<uint32> RateLimitSuppressed{0};
+		std::atomic<uint64> RateLimitNextCycles{0};
+
+		// Set once the `dbgLog.Callsite` trace event describing this callsite went out, see FDbgLogTrace.
+		std::atomic<bool> bTraceDescribed{false};
+
+	private:
+		// The plain verbosities come first, followed by the same again with SetColor, BreakOnLog and both.
+		static constexpr size_t GetLogRecordIndex(ELogVerbosity::Type Verbosity)
+		{
+			const size_t FlagSet = ((Verbosity & ELogVerbosity::SetColor) ? 1 : 0) | ((Verbosity & ELogVerbosity::BreakOnLog) ? 2 : 0);
+			return FlagSet * ELogVerbosity::NumVerbosity + (Verbosity & ELogVerbosity::VerbosityMask);
+		}
+
+		static constexpr ELogVerbosity::Type GetLogRecordVerbosity(size_t Index)
+		{
+			const size_t FlagSet = Index / ELogVerbosity::NumVerbosity;
+			return static_cast<ELogVerbosity::Type>(Index % ELogVerbosity::NumVerbosity
+				| ((FlagSet & 1) ? ELogVerbosity::SetColor : 0)
+				| ((FlagSet & 2) ? ELogVerbosity::BreakOnLog : 0));
+		}
+
+		template<size_t... Indices>
+		static constexpr std::array<FLogRecord, sizeof...(Indices)> MakeLogRecords(const std::source_location& InLocation,
+			std::array<::UE::Logging::Private::FStaticBasicLogDynamicData, NumLogRecords>& DynamicData, std::index_sequence<Indices...>)
+		{
+			return {{FLogRecord(TEXT("%s"), InLocation.file_name(), static_cast<int32>(InLocation.line()),
+				GetLogRecordVerbosity(Indices), DynamicData[Indices])...}};
+		}
+	};
+
+
+	// Folds Value into Seed for `.OnChange()`. FString by its characters (its GetTypeHash ignores case), then anything with a
+	// GetTypeHash, and only types without padding or float quirks (has_unique_object_representations) bytewise.
+	template<typename T>
+	uint64 HashOnChangeValue(uint64 Seed, const T& Value)
+	{
+		uint64 Hash = 0;
+		if constexpr (std::is_same_v<T, FString>)
+		{
+			Hash = CityHash64(reinterpret_cast<const char*>(*Value), Value.Len() * sizeof(TCHAR));
+		}
+		else if constexpr (requires { GetTypeHash(Value); })
+		{
+			Hash = GetTypeHash(Value);
+		}
+		else if constexpr (std::has_unique_object_representations_v<T>)
+		{
+			Hash = CityHash64(reinterpret_cast<const char*>(&Value), sizeof(T));
+		}
+		else
+		{
+			static_assert(TFalse<T>, "OnChange needs a type with GetTypeHash or one without padding that can be hashed bytewise.");
+		}
+		return Seed ^ (Hash + 0x9e3779b97f4a7c15ull + (Seed << 6) + (Seed >> 2));
+	}
+
+
 	struct DbgLogArgs
 	{
 		using ThisClass = DbgLogArgs;
 		template<typename... A>
-		friend void Log(int32 UniqueIdentifier, std::source_location Location,
-				DbgLogArgs LogArgs,
+		friend void Log(FDbgLogCallsite& Callsite,
+				DbgLogArgs& LogArgs,
 				std::wformat_string<TFormatted<A>...> Format,
 				A&&... Args);
 
 		DbgLogArgs() = default;
 
+		/**
+		 * Cheap gate that is run before any of the format arguments are evaluated. Resolves the category and checks the
+		 * condition, the category state and (for console only logs) the category verbosity, so suppressed logs never
+		 * pay for argument evaluation or formatting. `Log` must only be called once this returned true.
+		 */
+		bool ShouldLog(FDbgLogCallsite& Callsite);
+
+		// True if the console is the one and only place this log would end up in.
+		bool OutputsOnlyToConsole() const
+		{
+			return OutputDestinationValue == EDbgLogOutput::Con
+				&& bLogToSlateNotify == false
+				&& bLogToMessageDialog == false
+				&& bLogToEditorMessageLog == false
+				&& VisualLoggerOwnerValue == nullptr;
+		}
+
 		// The log category, can be anything you want but `dbg` is appended due to possible naming conflicts with existing categories (which can cause an asset).
-		ThisClass& Category(FName CategoryName) {LogCategoryName = CategoryName; return *this;}
+		ThisClass& Category(FName CategoryName) {LogCategoryName = CategoryName; LogCategoryLiteral = nullptr; return *this;}
+
+		// Same as above, string literals are cached per callsite by their address so they only get resolved once.
+		template<SIZE_T N>
+		ThisClass& Category(const ANSICHAR (&CategoryName)[N]) {LogCategoryLiteral = CategoryName; LogCategoryName = NAME_None; return *this;}
+
+		// Mutable buffers can change between calls, so those can't be cached by address and go through FName instead.
+		template<SIZE_T N>
+		ThisClass& Category(ANSICHAR (&CategoryName)[N]) {return Category(FName(CategoryName));}
 
 		// Takes a log category to use when logging.
 		ThisClass& Category(const FLogCategoryBase& InCategory) {LogCategory = &InCategory; return *this;}
@@ -384,7 +767,8 @@ namespace DBG::Log
 		ThisClass& Fatal() {VerbosityValue = ELogVerbosity::Fatal; return *this;}
 
 		// World context Object, can be used to append to the log the PIE ID as well as net mode.
-		ThisClass& WCO(const UObject* CO) {WCOResultValue = GEngine->GetWorldFromContextObject(CO, EGetWorldErrorMode::ReturnNull); return *this;}
+		// Only resolved to its world once the log is actually made.
+		ThisClass& WCO(const UObject* CO) {WCOValue = CO; return *this;}
 
 		// Outputs this log to the screen if possible (otherwise falls back to the console)
 		ThisClass& Screen() {OutputDestinationValue = EDbgLogOutput::Scr; return *this;}
@@ -404,8 +788,8 @@ namespace DBG::Log
 		// Duration for screen logs.
 		ThisClass& ScrnDuration(float Duration) {ScreenDurationValue = Duration; return *this;}
 
-		// Optional key for screen logs.
-		ThisClass& ScrnKey(int32 Key) {ScreenKeyValue.Emplace(Key) ; return *this;}
+		// Optional key for screen logs, mixed with the callsite so the same key from different callsites doesn't collide.
+		ThisClass& ScrnKey(uint64 Key) {ScreenKeyValue.Emplace(Key); return *this;}
 
 		// Condition for the log, great for things like CVars or only logging under certain conditions.
 		ThisClass& Condition(bool Condition) {bLogConditionValue = Condition; return *this;}
@@ -413,6 +797,26 @@ namespace DBG::Log
 		// If called, it enables logging of the source location, things like file name, line number etc.
 		ThisClass& LogSourceLoc() {bLogSourceLocation = true; return *this;}
 
+		// Only logs when any of the values differ from the previous call of this callsite, great for state printed every frame.
+		template<typename... V>
+		ThisClass& OnChange(const V&... Values)
+		{
+			uint64 Hash = 0;
+			((Hash = HashOnChangeValue(Hash, Values)), ...);
+			OnChangeHashValue = Hash != 0 ? Hash : 1; // Zero is what the callsite starts out with.
+			bHasOnChange = true;
+			return *this;
+		}
+
+		// Only the first call of this callsite is logged, great for one off warnings from Tick.
+		ThisClass& Once() {RateLimitValue = EDbgRateLimit::Once; return *this;}
+
+		// Only every Nth call of this callsite is logged (the 1st, N+1th...), the next log mentions how many were skipped.
+		ThisClass& EveryN(uint32 N) {RateLimitValue = EDbgRateLimit::EveryN; RateLimitEveryNValue = FMath::Max<uint32>(N, 1); return *this;}
+
+		// This callsite logs at most MaxPerSecond times a second, the next log mentions how many were skipped.
+		ThisClass& Throttle(float MaxPerSecond) {RateLimitValue = EDbgRateLimit::Throttle; RateLimitPerSecondValue = MaxPerSecond; return *this;}
+
 		// If called, enables the default format for the date and time which is prepended to the log.
 		ThisClass& LogDateAndTime() {bLogDateAndTime = true; return *this;}
 
@@ -625,6 +1029,36 @@ namespace DBG::Log
 			bool bOnlyLogVisually = true);
 
 	private:
+		enum struct EDbgRateLimit : uint8
+		{
+			None,
+			Once,
+			EveryN,
+			Throttle,
+		};
+
+		// ShouldLog without the tracing around it.
+		bool PassesGate(FDbgLogCallsite& Callsite);
+
+		// Applies `.Once()`, `.EveryN()` and `.Throttle()`, only counts calls that passed every other check.
+		bool PassesRateLimit(FDbgLogCallsite& Callsite);
+
+		// False if a VisualLog* option shouldn't store its shape, either there already is one or the visual logger isn't recording.
+		bool ShouldStoreVisualLog(bool bOnlyLogVisually);
+
+		static bool IsVisualLoggerRecording()
+		{
+#if ENABLE_VISUAL_LOG
+			return FVisualLogger::IsRecording();
+#else
+			return false;
+#endif
+		}
+
+		// Debug drawing is game thread only, from any other thread the world is resolved once we get there.
+		template<typename FuncType>
+		static void DrawOnGameThread(const UObject* WorldContextObject, FuncType&& Draw);
+
 		enum struct EDbgVisualLogShape : uint8
 		{
 			None,
@@ -637,8 +1071,37 @@ namespace DBG::Log
 			Capsule,
 		};
 
+#if ENABLE_VISUAL_LOG
+		// Only what the visual logger needs, so a log from another thread doesn't copy all of its args over to the game thread.
+		struct FVisualLogShape
+		{
+			const UObject* Owner;
+			ELogVerbosity::Type Verbosity;
+			EDbgVisualLogShape Shape;
+			FVector Location;
+			FRotator Rotation;
+			FVector Scale;
+			FVector VectorOne;
+			FVector VectorTwo;
+			FColor Color;
+			bool bWireframe;
+
+			// Game thread only.
+			void Output(const FLogCategoryBase& VisualLogCategory, const TCHAR* Message) const;
+		};
+
+		FVisualLogShape GetVisualLogShape() const
+		{
+			return {VisualLoggerOwnerValue, VerbosityValue, VisualLogShapeValue, VisualLogShapeLocationValue, VisualLogShapeRotationValue,
+				VisualLogShapeScaleValue, VisualLogVectorOne, VisualLogVectorTwo, VisualLogShapeColorValue, bDrawWireframeValue};
+		}
+#endif
+
 		const FLogCategoryBase* LogCategory			= nullptr;
-		const UWorld* WCOResultValue				= nullptr;
+		const FLogCategoryBase* ResolvedCategory	= nullptr;
+		int32 ResolvedStateId						= INDEX_NONE;
+		const ANSICHAR* LogCategoryLiteral			= nullptr;
+		const UObject* WCOValue						= nullptr;
 		const UObject* VisualLoggerOwnerValue		= nullptr;
 		TStringView<TCHAR> DateTimeFormat			= nullptr;
 		TFunction<void(EAppReturnType::Type Response)> AppMessageResponse = nullptr;
@@ -648,10 +1111,19 @@ namespace DBG::Log
 		FColor ScreenColorValue						= FColor::Transparent;
 
 		float ScreenDurationValue					= -1.f;
-		TOptional<int32> ScreenKeyValue				= NullOpt;
+		TOptional<uint64> ScreenKeyValue			= NullOpt;
 
 		EDbgLogOutput OutputDestinationValue		= EDbgLogOutput::Con;
 
+		EDbgRateLimit RateLimitValue				= EDbgRateLimit::None;
+		uint32 RateLimitEveryNValue					= 1;
+		float RateLimitPerSecondValue				= 0.f;
+
+		uint64 OnChangeHashValue					= 0;
+
+		// How many logs the rate limit swallowed since this callsite last logged.
+		uint32 SuppressedCountValue					= 0;
+
 
 		// All the visual logger related variables.
 		EDbgVisualLogShape VisualLogShapeValue		= EDbgVisualLogShape::None;
@@ -678,327 +1150,581 @@ namespace DBG::Log
 		uint16 bLogDateAndTime:1 					= false;
 		uint16 bDrawWireframeValue:1 				= false;
 		uint16 bOnlyUseVisualLogger:1 				= false;
+		uint16 bHasOnChange:1 						= false;
+		uint16 bVisualLogDiscarded:1 				= false;
 
 		EAppMsgType::Type AppMsgType				= EAppMsgType::Type::Ok;
 		ELogVerbosity::Type VerbosityValue			= ELogVerbosity::Display;
 	};
 
-	struct FDbgLogSingleton
+	/**
+	 * Holds the enabled/disabled state of every category we've seen in a dense, append only table.
+	 * Registering takes a lock but the states themselves are atomics, so checking a category from the hot path is a
+	 * single relaxed load that is safe from any thread, even while the console commands are flipping them.
+	 */
+	struct DBGLOG_API FDbgLogSingleton
 	{
+		static constexpr int32 MaxCategories = 4096;
+
 		FDbgLogSingleton();
 
+		// Returns the dense id for the category, registering it if needed. Takes a lock, so cache the result.
+		int32 FindOrAddCategoryId(FName CategoryName);
+
+		// Wait-free, safe to call from any thread.
+		bool IsCategoryDisabled(int32 CategoryId) const
+		{
+			return CategoryId != INDEX_NONE && CategoryStates[CategoryId].bState.load(std::memory_order_relaxed) == false;
+		}
+
 		template<bool bAddIfMissing>
-		bool IsCategoryDisabled(FName CategoryName)
+		void SetCategoryState(FName CategoryName, bool bNewState)
 		{
-			if (FRegisteredCategory* Cat = CategoryMap.Find(CategoryName))
+			int32 CategoryId = FindCategoryId(CategoryName);
+			if (CategoryId == INDEX_NONE)
 			{
-				return Cat->bState == false;
+				if constexpr (bAddIfMissing)
+				{
+					UE_LOG(dbgLOG, Warning, TEXT("Failed to to locate category %s, making state entry anyway."), *CategoryName.ToString());
+					CategoryId = FindOrAddCategoryId(CategoryName);
+				}
 			}
 
-			if constexpr (bAddIfMissing)
+			if (CategoryId != INDEX_NONE)
 			{
-				CategoryMap.Emplace(CategoryName, {true});
+				CategoryStates[CategoryId].bState.store(bNewState, std::memory_order_relaxed);
 			}
-			return false;
 		}
 
-		template<bool bAddIfMissing>
-		void SetCategoryState(FName CategoryName, bool bNewState)
+		void SetAllCategoriesState(bool bNewState)
 		{
-			if (FRegisteredCategory* Cat = CategoryMap.Find(CategoryName))
+			const int32 Num = NumCategories.load(std::memory_order_acquire);
+			for (int32 CategoryId = 0; CategoryId < Num; ++CategoryId)
 			{
-				Cat->bState = bNewState;
-				return;
+				CategoryStates[CategoryId].bState.store(bNewState, std::memory_order_relaxed);
+			}
+		}
+
+		void StartupModule();
+		void ShutdownModule();
+
+		// The run of repeated messages a log just ended, see Deduplicate.
+		struct FRepeatRun
+		{
+			uint32 Count = 0;
+			double Milliseconds = 0.0;
+			bool bSameMessage = false;
+
+			// Where the repeated message came from, the repeat count is reported under these rather than the log that ended the run.
+			const FDbgLogCallsite* Callsite = nullptr;
+			const FLogCategoryBase* Category = nullptr;
+			ELogVerbosity::Type Verbosity = ELogVerbosity::Display;
+		};
+
+		/**
+		 * Collapses identical consecutive messages of a category that arrive within WindowCycles of the first one.
+		 * Returns false if the message is a repeat that should be swallowed, otherwise fills OutEndedRun with the run of
+		 * repeats this message just ended (Count is zero if there wasn't one). Lock-free, a racing log just misses a repeat.
+		 */
+		bool Deduplicate(int32 CategoryId, uint64 MessageHash, uint64 WindowCycles, const FDbgLogCallsite& Callsite,
+			const FLogCategoryBase& Category, ELogVerbosity::Type Verbosity, FRepeatRun& OutEndedRun)
+		{
+			FRegisteredCategory& Entry = CategoryStates[CategoryId];
+			const uint64 Now = FPlatformTime::Cycles64();
+
+			if (Entry.DedupHash.load(std::memory_order_relaxed) == MessageHash
+			&& Now - Entry.DedupWindowStart.load(std::memory_order_relaxed) < WindowCycles)
+			{
+				Entry.DedupLastRepeat.store(Now, std::memory_order_relaxed);
+				Entry.DedupRepeats.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+
+			const uint64 PreviousHash = Entry.DedupHash.exchange(MessageHash, std::memory_order_relaxed);
+			const uint64 PreviousStart = Entry.DedupWindowStart.exchange(Now, std::memory_order_relaxed);
+			OutEndedRun.Count = Entry.DedupRepeats.exchange(0, std::memory_order_relaxed);
+			OutEndedRun.Callsite = Entry.DedupCallsite.exchange(&Callsite, std::memory_order_relaxed);
+			OutEndedRun.Category = Entry.DedupCategory.exchange(&Category, std::memory_order_relaxed);
+			OutEndedRun.Verbosity = static_cast<ELogVerbosity::Type>(Entry.DedupVerbosity.exchange(Verbosity, std::memory_order_relaxed));
+			if (OutEndedRun.Count > 0)
+			{
+				const uint64 LastRepeat = Entry.DedupLastRepeat.load(std::memory_order_relaxed);
+				OutEndedRun.Milliseconds = FPlatformTime::ToMilliseconds64(LastRepeat > PreviousStart ? LastRepeat - PreviousStart : 0);
+				OutEndedRun.bSameMessage = PreviousHash == MessageHash;
 			}
+			return true;
+		}
+
+		/**
+		 * Reports the repeats swallowed by runs nobody has ended yet, as "(previous message repeated xN over T ms)" under the
+		 * repeated message's callsite. Only runs whose window is over unless bAll, which also forgets the last message of
+		 * every category so the next one is logged in full. Called at the end of every frame and whenever the window changes.
+		 */
+		void FlushRepeats(bool bAll);
 
-			if constexpr (bAddIfMissing)
+		// Calls Func(FName CategoryName, bool bState) for every registered category.
+		template<typename FuncType>
+		void ForEachCategory(FuncType&& Func) const
+		{
+			const int32 Num = NumCategories.load(std::memory_order_acquire);
+			for (int32 CategoryId = 0; CategoryId < Num; ++CategoryId)
 			{
-				UE_LOG(dbgLOG, Warning, TEXT("Failed to to locate category %s, making state entry anyway."), *CategoryName.ToString());
-				CategoryMap.Emplace(CategoryName, {bNewState});
+				Func(CategoryStates[CategoryId].Name, CategoryStates[CategoryId].bState.load(std::memory_order_relaxed));
 			}
 		}
 
+	private:
+		int32 FindCategoryId(FName CategoryName) const;
+
 		struct FRegisteredCategory
 		{
-			bool bState;
+			// Written once before the entry is published through NumCategories.
+			FName Name;
+			std::atomic<bool> bState{true};
+
+			// Last message this category logged and the repeats of it we've swallowed since, see Deduplicate.
+			std::atomic<uint64> DedupHash{0};
+			std::atomic<uint64> DedupWindowStart{0};
+			std::atomic<uint64> DedupLastRepeat{0};
+			std::atomic<uint32> DedupRepeats{0};
+			std::atomic<const FDbgLogCallsite*> DedupCallsite{nullptr};
+			std::atomic<const FLogCategoryBase*> DedupCategory{nullptr};
+			std::atomic<uint8> DedupVerbosity{0};
 		};
-		TMap<FName, FRegisteredCategory> CategoryMap;
+		FRegisteredCategory CategoryStates[MaxCategories];
+		std::atomic<int32> NumCategories{0};
+
+		// Only used while registering, the hot path never touches it.
+		mutable FCriticalSection RegistrationLock;
+		TMap<FName, int32> CategoryIds;
+
+		FDelegateHandle EndFrameHandle;
 	};
 
 	DBGLOG_API extern FDbgLogSingleton GDbgLogSingleton;
 
-	template<typename... A>
-	void Log(int32 UniqueIdentifier, std::source_location Location, DbgLogArgs LogArgs, std::wformat_string<TFormatted<A>...> Format, A&&... Args)
+	// 0 turns deduplication off, see `dbgLog.Dedup.WindowMs`.
+	DBGLOG_API extern float GDbgLogDedupWindowMs;
+
+	/**
+	 * Appends the local wall clock time of a `FPlatformTime::Cycles64()` stamp, formatted like `FDateTime::ToString`
+	 * (the default format when Format is empty). The text is cached per thread and only rendered again once the
+	 * second (or the millisecond, for formats with `%s`) changes, so it's a copy for almost every log.
+	 */
+	DBGLOG_API void AppendDateTime(FStringBuilderBase& Builder, uint64 Cycles, TStringView<TCHAR> Format);
+
+
+	// This is basically UE_LOG but expanded so we dont need compile time log category stuff,
+	// with the async backend enabled the actual write happens on the dbgLog writer thread.
+	// A DateTimeFormat means Msg still needs the `.LogDateAndTime()` prefix for Cycles, which is left to whoever writes it out.
+	inline void OutputLog(const FDbgLogCallsite& Site, const FLogCategoryBase& LC, ELogVerbosity::Type Verb, const TCHAR* Msg,
+		uint64 Cycles = FPlatformTime::Cycles64(), const TStringView<TCHAR>* DateTimeFormat = nullptr)
 	{
-		if(LogArgs.VerbosityValue == ELogVerbosity::NoLogging
-		|| LogArgs.bLogConditionValue == false)
-		{
-			return;
-		}
+		DBGLOG_TRACE_SCOPE(Console);
+		const std::source_location& Loc = Site.Location;
 
-		// Work out which category to use, we we're either passed that exists, passed one we need to create ourself, or use the default one.
-		const FLogCategoryBase* LogCategory = nullptr;
-		TOptional<FLogCategory<ELogVerbosity::Display, ELogVerbosity::All>> OptionallyCreatedCategory;
+		const FDbgLogCallsite::FLogRecord* LOG_Static = &Site.GetLogRecord(Verb);
 
-		if (LogArgs.LogCategory != nullptr)
-		{
-			LogCategory = LogArgs.LogCategory;
-		}
-		else if (LogArgs.LogCategoryName.IsNone() == false && LogArgs.LogCategoryName != dbgLOG.GetCategoryName())
-		{
-			FName CategoryName = FName{FString::Format(TEXT("dbg{0}"), {LogArgs.LogCategoryName.ToString()})};
-			OptionallyCreatedCategory.Emplace(CategoryName);
-			LogCategory = &OptionallyCreatedCategory.GetValue();
-		}
-		else // Lastly fallback to the default if the user supplied no category.
+		if ((Verb & ELogVerbosity::VerbosityMask) == ::ELogVerbosity::Fatal)
 		{
-			LogCategory = &dbgLOG;
+			// Make sure everything queued up before the crash makes it out first.
+			GDbgLogAsyncBackend.Flush();
+			GDbgLogBinarySink.Flush();
+			::UE::Logging::Private::BasicFatalLog(LC, LOG_Static, Msg);
 		}
-
-		// User has disabled it via the `dbgLog.DisableCategory Foo`, must re-enable it via `dbgLog.EnableCategory Foo`
-		if (GDbgLogSingleton.IsCategoryDisabled<true>(LogCategory->GetCategoryName()))
+		else if ((Verb & ::ELogVerbosity::VerbosityMask) <= ::ELogVerbosity::VeryVerbose)
 		{
-			return;
+			if ((Verb & ::ELogVerbosity::VerbosityMask) <= LC.GetCompileTimeVerbosity())
+			{
+				if (!LC.IsSuppressed(Verb))
+				{
+					if (GDbgLogAsyncBackend.IsActive())
+					{
+						FDbgLogRecord Record{&LC, Loc.file_name(), static_cast<int32>(Loc.line()), Verb, Cycles, Msg};
+						Site.SetLogRecord(Record);
+						if (DateTimeFormat)
+						{
+							Record.bLogDateAndTime = true;
+							Record.DateTimeFormat = FString(*DateTimeFormat);
+						}
+						GDbgLogAsyncBackend.Enqueue(MoveTemp(Record));
+					}
+					else if (DateTimeFormat)
+					{
+						// The backend was turned off after Log left the date to it.
+						TStringBuilder<512> DatedBuilder;
+						DatedBuilder << TEXT("(");
+						AppendDateTime(DatedBuilder, Cycles, *DateTimeFormat);
+						DatedBuilder << TEXT(") ") << Msg;
+						::UE::Logging::Private::BasicLog(LC, LOG_Static, DatedBuilder.ToString());
+					}
+					else
+					{
+						::UE::Logging::Private::BasicLog(LC, LOG_Static, Msg);
+					}
+				}
+			}
 		}
+	}
 
-		// Format the actual log provided from the user.
-		FString Message = FormatMessage(std::move(Format), std::forward<A>(Args)...);
-
+	inline bool DbgLogArgs::ShouldLog(FDbgLogCallsite& Callsite)
+	{
+		DBGLOG_TRACE_SCOPE(Gate);
 
-		// Configure how we present the log now.
-		static auto NetModeToStr = [](ENetMode Mode) -> FString
+		const bool bShouldLog = PassesGate(Callsite);
+		if (bShouldLog == false)
 		{
-			static FString StandAlone{TEXT("Standalone")};
-			static FString DedicatedServer{TEXT("Dedicated Server")};
-			static FString ListenServer{TEXT("Listen Server")};
-			static FString Client{TEXT("Client")};
-			static FString Max{TEXT("MAX")};
-			static FString Unknown{TEXT("Unknown")};
-
-			switch (Mode)
+			if (DBGLOG_TRACE_IS_ENABLED())
 			{
-				case NM_Standalone:			return StandAlone;
-				case NM_DedicatedServer:	return DedicatedServer;
-				case NM_ListenServer:		return ListenServer;
-				case NM_Client:				return Client;
-				case NM_MAX:				return Max;
-				default:					return Unknown;
+				GDbgLogTrace.CountSuppressed();
 			}
-		};
 
-		static auto WorldToString = [](const UWorld* W)
-		{
-			FWorldContext* WC = GEngine->GetWorldContextFromWorld(W);
-			if (!WC)
+			if (GDbgLogStats.IsCollecting())
 			{
-				static FString NullWCO = TEXT("NullWorld");
-				return NullWCO;
+				GDbgLogStats.AddSuppressed(Callsite);
 			}
-			return FString::Format(TEXT("{0} | Instance: {1}"),
-				{NetModeToStr(W->GetNetMode()), WC->PIEInstance});
-		};
+		}
+		return bShouldLog;
+	}
 
-		// make it a little nicer to read.
-		static auto SourceLocationToStr = [](std::source_location& L) -> FString
+	inline bool DbgLogArgs::PassesGate(FDbgLogCallsite& Callsite)
+	{
+		if(VerbosityValue == ELogVerbosity::NoLogging
+		|| bLogConditionValue == false
+		|| (VerbosityValue & ELogVerbosity::VerbosityMask) > DBG_LOG_COMPILED_IN_VERBOSITY)
 		{
-			FString FuncName(L.function_name());
-			FuncName.ReplaceInline(TEXT(" __cdecl"), TEXT(""));
-			return FString::Format(TEXT("[File: {0} ({1}), {2}]"),
-				{FPaths::GetCleanFilename(StringCast<wchar_t>(L.file_name()).Get()), L.line(), FuncName});
-		};
+			return false;
+		}
 
+		// Only meant for the visual logger and it isn't recording, nothing would ever see this log.
+		if (bVisualLogDiscarded && bOnlyUseVisualLogger)
+		{
+			return false;
+		}
 
-		TStringBuilder<96> MessagePrefixBuilder;
+		// Work out which category to use, we we're either passed that exists, passed one we need to create ourself, or use the default one.
+		// Whatever it is, the callsite caches the handle so this is only resolved properly the first time around.
+		const FDbgLogCategoryHandle* Handle = Callsite.CachedCategory.load(std::memory_order_acquire);
 
-		if (LogArgs.bLogDateAndTime)
+		if (LogCategoryLiteral != nullptr && LogCategory == nullptr)
 		{
-			if (LogArgs.DateTimeFormat != nullptr)
+			if (Handle == nullptr || Handle->Literal != LogCategoryLiteral)
 			{
-				MessagePrefixBuilder.Appendf(TEXT("(%s) "), *FDateTime::Now().ToString(LogArgs.DateTimeFormat.GetData()));
+				Handle = FDbgLogCategoryRegistry::Get().FindOrAdd(LogCategoryLiteral);
+				Callsite.CachedCategory.store(Handle, std::memory_order_release);
+			}
+		}
+		else if (LogCategory == nullptr && LogCategoryName.IsNone() == false && LogCategoryName != dbgLOG.GetCategoryName())
+		{
+			if (Handle == nullptr || Handle->Literal != nullptr || Handle->Existing != nullptr || Handle->Name != LogCategoryName)
+			{
+				Handle = FDbgLogCategoryRegistry::Get().FindOrAdd(LogCategoryName);
+				Callsite.CachedCategory.store(Handle, std::memory_order_release);
+			}
+		}
+		else // Either passed one that exists or lastly fallback to the default if the user supplied no category.
+		{
+			const FLogCategoryBase* ExistingCategory = LogCategory != nullptr ? LogCategory : &dbgLOG;
+			if (Handle == nullptr || Handle->Existing != ExistingCategory)
+			{
+				Handle = FDbgLogCategoryRegistry::Get().FindOrAdd(*ExistingCategory);
+				Callsite.CachedCategory.store(Handle, std::memory_order_release);
+			}
+		}
+
+		ResolvedCategory = Handle->Category;
+		ResolvedStateId = Handle->StateId;
+
+		// User has disabled it via the `dbgLog.DisableCategory Foo`, must re-enable it via `dbgLog.EnableCategory Foo`
+		if (GDbgLogSingleton.IsCategoryDisabled(Handle->StateId))
+		{
+			return false;
+		}
+
+		// The category verbosity only ever gates the console output, so we can only bail out here
+		// if the console is the one and only place this log would end up in.
+		if (OutputsOnlyToConsole())
+		{
+			const ELogVerbosity::Type Verb = static_cast<ELogVerbosity::Type>(VerbosityValue & ELogVerbosity::VerbosityMask);
+			if (Verb != ELogVerbosity::Fatal
+			&& (Verb > ResolvedCategory->GetCompileTimeVerbosity() || ResolvedCategory->IsSuppressed(Verb)))
+			{
+				return false;
+			}
+		}
+
+		uint64 PreviousOnChangeHash = 0;
+		if (bHasOnChange)
+		{
+			PreviousOnChangeHash = Callsite.OnChangeHash.load(std::memory_order_relaxed);
+			if (PreviousOnChangeHash == OnChangeHashValue)
+			{
+				return false;
+			}
+		}
+
+		if (RateLimitValue != EDbgRateLimit::None && PassesRateLimit(Callsite) == false)
+		{
+			return false;
+		}
+
+		// Only remember the values once the rate limit let them through, otherwise a change it held back would never be logged.
+		// Losing the exchange to another thread that already logged these same values means this one is a repeat.
+		if (bHasOnChange
+		&& Callsite.OnChangeHash.compare_exchange_strong(PreviousOnChangeHash, OnChangeHashValue, std::memory_order_relaxed) == false
+		&& PreviousOnChangeHash == OnChangeHashValue)
+		{
+			return false;
+		}
+
+		return true;
+	}
+
+	inline bool DbgLogArgs::PassesRateLimit(FDbgLogCallsite& Callsite)
+	{
+		switch (RateLimitValue)
+		{
+			case EDbgRateLimit::Once:
+			{
+				return Callsite.RateLimitCalls.exchange(1, std::memory_order_relaxed) == 0;
+			}
+			case EDbgRateLimit::EveryN:
+			{
+				if (Callsite.RateLimitCalls.fetch_add(1, std::memory_order_relaxed) % RateLimitEveryNValue != 0)
+				{
+					Callsite.RateLimitSuppressed.fetch_add(1, std::memory_order_relaxed);
+					return false;
+				}
+				break;
+			}
+			case EDbgRateLimit::Throttle:
+			{
+				if (RateLimitPerSecondValue <= 0.f)
+				{
+					return false;
+				}
+
+				const uint64 Now = FPlatformTime::Cycles64();
+				const uint64 Interval = static_cast<uint64>(1.0 / (RateLimitPerSecondValue * FPlatformTime::GetSecondsPerCycle64()));
+				uint64 Next = Callsite.RateLimitNextCycles.load(std::memory_order_relaxed);
+
+				// Losing the race means another thread just took this window.
+				if (Now < Next || Callsite.RateLimitNextCycles.compare_exchange_strong(Next, Now + Interval, std::memory_order_relaxed) == false)
+				{
+					Callsite.RateLimitSuppressed.fetch_add(1, std::memory_order_relaxed);
+					return false;
+				}
+				break;
+			}
+			default:
+				break;
+		}
+
+		SuppressedCountValue = Callsite.RateLimitSuppressed.exchange(0, std::memory_order_relaxed);
+		return true;
+	}
+
+
+	/**
+	 * Hands Log a thread local builder to write the prefix and message into, so the common case never allocates.
+	 * Logging from inside of a log (a formatter, a slate notification...) gets a builder of its own instead.
+	 */
+	class FDbgLogMessageBuffer
+	{
+	public:
+		FDbgLogMessageBuffer()
+			: bOwnsShared(SharedInUse() == false)
+		{
+			if (bOwnsShared)
+			{
+				SharedInUse() = true;
+				Builder = &Shared();
+				Builder->Reset();
 			}
 			else
 			{
-				MessagePrefixBuilder.Appendf(TEXT("(%s) "), *FDateTime::Now().ToString());
+				Builder = &Fallback.Emplace();
+			}
+		}
+
+		~FDbgLogMessageBuffer()
+		{
+			if (bOwnsShared)
+			{
+				SharedInUse() = false;
 			}
 		}
 
-		if (LogArgs.PrefixValue.Len() > 0)
+		UE_NONCOPYABLE(FDbgLogMessageBuffer);
+
+		FStringBuilderBase& Get() { return *Builder; }
+
+	private:
+		// Grows to fit the longest log this thread has made and keeps that memory around.
+		static TStringBuilder<1024>& Shared()
 		{
-			MessagePrefixBuilder.Appendf(TEXT("[%s] "), *LogArgs.PrefixValue);
+			thread_local TStringBuilder<1024> SharedBuilder;
+			return SharedBuilder;
 		}
 
-		if (const UWorld* W = LogArgs.WCOResultValue)
+		static bool& SharedInUse()
 		{
+			thread_local bool bSharedInUse = false;
+			return bSharedInUse;
+		}
+
+		const bool bOwnsShared;
+		FStringBuilderBase* Builder = nullptr;
+		TOptional<TStringBuilder<256>> Fallback;
+	};
+
+
+	// Expects `LogArgs.ShouldLog()` to have been called and returned true, the macros take care of that for you.
+	template<typename... A>
+	void Log(FDbgLogCallsite& Callsite, DbgLogArgs& LogArgs, std::wformat_string<TFormatted<A>...> Format, A&&... Args)
+	{
+		const std::source_location& Location = Callsite.Location;
+		const FLogCategoryBase* LogCategory = LogArgs.ResolvedCategory;
+		check(LogCategory);
+
+		DBGLOG_TRACE_SCOPE(Log);
+
+		// When this log happened, only turned into text by whatever needs it.
+		const uint64 Cycles = FPlatformTime::Cycles64();
+
+		// Everything until we return counts towards this callsite in `dbgLog.Stats`.
+		FDbgLogStatsScope StatsScope(Callsite, Cycles);
+
+		if (DBGLOG_TRACE_IS_ENABLED())
+		{
+			GDbgLogTrace.TraceLog(Callsite.Hash, Callsite.bTraceDescribed, Location.file_name(), Location.line(),
+				*LogCategory, LogArgs.VerbosityValue, Cycles);
+		}
+
+
+		// The prefix and then the message are written into the same reusable buffer,
+		// so a typical log doesn't touch the heap on its way to the output devices.
+		FDbgLogMessageBuffer MessageBuffer;
+		FStringBuilderBase& MessageBuilder = MessageBuffer.Get();
+
+		const bool bConsoleOnly = LogArgs.OutputsOnlyToConsole()
+			&& (LogArgs.VerbosityValue & ELogVerbosity::VerbosityMask) != ELogVerbosity::Fatal;
+		const bool bBinary = bConsoleOnly && GDbgLogBinarySink.IsEnabled();
+
+		// Console only logs on their way to the writer thread get their date rendered there, from Cycles, so the caller
+		// doesn't pay for it.
+		const bool bAsyncDateTime = LogArgs.bLogDateAndTime && bConsoleOnly && bBinary == false && GDbgLogAsyncBackend.IsActive();
+
+		{
+			DBGLOG_TRACE_SCOPE(Prefix);
+
+			// Binary records carry their own timestamp which the decoder turns into text.
+			if (LogArgs.bLogDateAndTime && bBinary == false && bAsyncDateTime == false)
+			{
+				MessageBuilder << TEXT("(");
+				AppendDateTime(MessageBuilder, Cycles, LogArgs.DateTimeFormat);
+				MessageBuilder << TEXT(") ");
+			}
+
+			if (LogArgs.SuppressedCountValue > 0)
+			{
+				MessageBuilder.Appendf(TEXT("(suppressed %u messages) "), LogArgs.SuppressedCountValue);
+			}
+
+			if (LogArgs.PrefixValue.Len() > 0)
+			{
+				MessageBuilder.Appendf(TEXT("[%s] "), *LogArgs.PrefixValue);
+			}
+
+			if (LogArgs.WCOValue)
+			{
+				if (const UWorld* W = GEngine->GetWorldFromContextObject(LogArgs.WCOValue, EGetWorldErrorMode::ReturnNull))
+				{
+					GDbgLogWorldPrefixCache.AppendPrefix(MessageBuilder, W);
+				}
+			}
+
 			if (LogArgs.bLogSourceLocation)
 			{
-				MessagePrefixBuilder.Appendf(TEXT("[%s] %s "), *WorldToString(W), *SourceLocationToStr(Location));
+				Callsite.AppendSourceLocation(MessageBuilder);
+				MessageBuilder << TEXT(" ");
 			}
-			else
+		}
+
+		// The binary sink stores the raw arguments and leaves the formatting to the decoder.
+		if (bBinary)
+		{
+			DBGLOG_TRACE_SCOPE(BinarySink);
+			GDbgLogBinarySink.Write(Callsite.BinaryId, Location, Cycles, GetFormatString(Format), *LogCategory, LogArgs.VerbosityValue,
+				MessageBuilder.ToView(), Args...);
+			return;
+		}
+
+		// If every argument can be captured as is, let the async writer thread do the formatting for us.
+		if constexpr ((TDeferrableArgument<A> && ...))
+		{
+			if (bConsoleOnly && GDbgLogAsyncBackend.ShouldDeferFormatting())
 			{
-				MessagePrefixBuilder.Appendf(TEXT("[%s] "), *WorldToString(W));
+				DBGLOG_TRACE_SCOPE(AsyncEnqueue);
+				FDbgLogRecord Record{LogCategory, Location.file_name(), static_cast<int32>(Location.line()),
+					LogArgs.VerbosityValue, Cycles, FString(MessageBuilder.ToView())};
+
+				Callsite.SetLogRecord(Record);
+				if (bAsyncDateTime)
+				{
+					Record.bLogDateAndTime = true;
+					Record.DateTimeFormat = FString(LogArgs.DateTimeFormat);
+				}
+				Record.Format = GetFormatString(Format);
+				Record.FormatFunc = &FormatDeferredMessage<A...>;
+
+				const TDeferredArguments<A...> Captured{Args...};
+				Record.ArgData.Append(reinterpret_cast<const uint8*>(&Captured), sizeof(Captured));
+
+				GDbgLogAsyncBackend.Enqueue(MoveTemp(Record));
+				return;
 			}
 		}
-		else if (LogArgs.bLogSourceLocation)
+
+		// Format the actual log provided from the user.
+		const int32 PrefixLen = MessageBuilder.Len();
 		{
-			MessagePrefixBuilder.Appendf(TEXT("%s "), *SourceLocationToStr(Location));
+			DBGLOG_TRACE_SCOPE(Format);
+			const uint64 FormatStartCycles = StatsScope.IsActive() ? FPlatformTime::Cycles64() : 0;
+			FormatMessageTo(MessageBuilder, std::move(Format), std::forward<A>(Args)...);
+			if (StatsScope.IsActive())
+			{
+				StatsScope.AddFormatCycles(FPlatformTime::Cycles64() - FormatStartCycles);
+			}
 		}
 
-		if (MessagePrefixBuilder.Len() > 0)
+		if (DBGLOG_TRACE_IS_ENABLED())
 		{
-			Message.InsertAt(0, MessagePrefixBuilder.ToString());
+			GDbgLogTrace.CountFormattedBytes((MessageBuilder.Len() - PrefixLen) * sizeof(TCHAR));
 		}
 
+		const TCHAR* Message = MessageBuilder.ToString();
+
 
 #if ENABLE_VISUAL_LOG
-		// The reason for manually calling these instead of using VLOG is that VLOG wanted to be annoying and
-		// assume our log verbosity is a constant IE `ELogVerbosity::MacroVerbosity`
 		if(LogArgs.VisualLoggerOwnerValue && FVisualLogger::IsRecording())
 		{
-			switch (LogArgs.VisualLogShapeValue)
+			DBGLOG_TRACE_SCOPE(VisualLog);
+			if (IsInGameThread())
 			{
-				case DbgLogArgs::EDbgVisualLogShape::None:
-					{
-						FVisualLogger::CategorizedLogf(LogArgs.VisualLoggerOwnerValue, *LogCategory,
-							LogArgs.VerbosityValue, TEXT("%s"), *Message);
-						break;
-					}
-				case DbgLogArgs::EDbgVisualLogShape::Sphere:
-					{
-	#if UE_VERSION_NEWER_THAN(5, 4, 0)
-						FVisualLogger::SphereLogf(LogArgs.VisualLoggerOwnerValue,
-							*LogCategory, LogArgs.VerbosityValue,
-							LogArgs.VisualLogShapeLocationValue,
-							LogArgs.VisualLogVectorOne.X,
-							LogArgs.VisualLogShapeColorValue,
-							LogArgs.bDrawWireframeValue,
-							TEXT("%s"), *Message);
-	#else
-						FVisualLogger::GeometryShapeLogf(LogArgs.VisualLoggerOwnerValue,
-							*LogCategory, LogArgs.VerbosityValue,
-							LogArgs.VisualLogShapeLocationValue,
-							LogArgs.VisualLogVectorOne.X,
-							LogArgs.VisualLogShapeColorValue,
-							TEXT("%s"), *Message);
-	#endif
-						break;
-					}
-				case DbgLogArgs::EDbgVisualLogShape::Box:
-					{
-	#if UE_VERSION_NEWER_THAN(5, 4, 0)
-						FVisualLogger::BoxLogf(LogArgs.VisualLoggerOwnerValue,
-							*LogCategory, LogArgs.VerbosityValue,
-							FBox{LogArgs.VisualLogVectorOne, LogArgs.VisualLogVectorTwo},
-							FMatrix{FScaleMatrix(LogArgs.VisualLogShapeScaleValue) *
-									FRotationMatrix(LogArgs.VisualLogShapeRotationValue) *
-									FTranslationMatrix(LogArgs.VisualLogShapeLocationValue)},
-							LogArgs.VisualLogShapeColorValue,
-							LogArgs.bDrawWireframeValue,
-							TEXT("%s"), *Message);
-	#else
-						FVisualLogger::GeometryBoxLogf(LogArgs.VisualLoggerOwnerValue,
-							*LogCategory, LogArgs.VerbosityValue,
-							FBox{LogArgs.VisualLogVectorOne, LogArgs.VisualLogVectorTwo},
-							FMatrix{FScaleMatrix(LogArgs.VisualLogShapeScaleValue) *
-									FRotationMatrix(LogArgs.VisualLogShapeRotationValue) *
-									FTranslationMatrix(LogArgs.VisualLogShapeLocationValue)},
-							LogArgs.VisualLogShapeColorValue,
-							TEXT("%s"), *Message);
-	#endif
-						break;
-					}
-				case DbgLogArgs::EDbgVisualLogShape::Cone:
-					{
-	#if UE_VERSION_NEWER_THAN(5, 4, 0)
-						FVisualLogger::ConeLogf(LogArgs.VisualLoggerOwnerValue,
-							*LogCategory, LogArgs.VerbosityValue,
-							LogArgs.VisualLogShapeLocationValue,
-							LogArgs.VisualLogVectorOne,
-							LogArgs.VisualLogVectorTwo.X,
-							LogArgs.VisualLogVectorTwo.Y,
-							LogArgs.VisualLogShapeColorValue,
-							LogArgs.bDrawWireframeValue,
-							TEXT("%s"), *Message);
-	#else
-						FVisualLogger::GeometryShapeLogf(LogArgs.VisualLoggerOwnerValue,
-							*LogCategory, LogArgs.VerbosityValue,
-							LogArgs.VisualLogShapeLocationValue,
-							LogArgs.VisualLogVectorOne,
-							LogArgs.VisualLogVectorTwo.X,
-							LogArgs.VisualLogVectorTwo.Y,
-							LogArgs.VisualLogShapeColorValue,
-							TEXT("%s"), *Message);
-
-						break;
-	#endif
-					}
-				case DbgLogArgs::EDbgVisualLogShape::Line:
-					{
-	#if UE_VERSION_NEWER_THAN(5, 4, 0)
-						FVisualLogger::SegmentLogf(LogArgs.VisualLoggerOwnerValue,
-							*LogCategory, LogArgs.VerbosityValue,
-							LogArgs.VisualLogShapeLocationValue,
-							LogArgs.VisualLogVectorOne,
-							LogArgs.VisualLogShapeColorValue,
-							static_cast<uint16>(LogArgs.VisualLogVectorTwo.X),
-							TEXT("%s"), *Message);
-	#else
-						FVisualLogger::GeometryShapeLogf(LogArgs.VisualLoggerOwnerValue,
-							*LogCategory, LogArgs.VerbosityValue,
-							LogArgs.VisualLogShapeLocationValue,
-							LogArgs.VisualLogVectorOne,
-							LogArgs.VisualLogShapeColorValue,
-							static_cast<uint16>(LogArgs.VisualLogVectorTwo.X),
-							TEXT("%s"), *Message);
-	#endif
-
-						break;
-					}
-				case DbgLogArgs::EDbgVisualLogShape::Arrow:
-					{
-						FVisualLogger::ArrowLogf(LogArgs.VisualLoggerOwnerValue,
-							*LogCategory, LogArgs.VerbosityValue,
-							LogArgs.VisualLogShapeLocationValue,
-							LogArgs.VisualLogVectorOne,
-							LogArgs.VisualLogShapeColorValue,
-							TEXT("%s"), *Message);
-						break;
-					}
-				case DbgLogArgs::EDbgVisualLogShape::Disk:
-					{
-						FVisualLogger::CircleLogf(LogArgs.VisualLoggerOwnerValue,
-							*LogCategory, LogArgs.VerbosityValue,
-							LogArgs.VisualLogShapeLocationValue,
-							LogArgs.VisualLogVectorOne,
-							LogArgs.VisualLogVectorTwo.X,
-							LogArgs.VisualLogShapeColorValue,
-							static_cast<uint16>(LogArgs.VisualLogVectorTwo.Y),
-							TEXT("%s"), *Message);
-						break;
-					}
-				case DbgLogArgs::EDbgVisualLogShape::Capsule:
+				LogArgs.GetVisualLogShape().Output(*LogCategory, Message);
+			}
+			else
+			{
+				// The owner could be gone by the time the game thread gets to it.
+				GDbgLogGameThread.Run([VisualLogShape = LogArgs.GetVisualLogShape(), Owner = TWeakObjectPtr<const UObject>(LogArgs.VisualLoggerOwnerValue),
+					LogCategory, VisualLogMessage = FString(Message)]()
+				{
+					if (Owner.IsValid())
 					{
-	#if UE_VERSION_NEWER_THAN(5, 4, 0)
-						FVisualLogger::CapsuleLogf(LogArgs.VisualLoggerOwnerValue,
-							*LogCategory, LogArgs.VerbosityValue,
-							LogArgs.VisualLogShapeLocationValue,
-							LogArgs.VisualLogVectorOne.X,
-							LogArgs.VisualLogVectorOne.Y,
-							LogArgs.VisualLogShapeRotationValue.Quaternion(),
-							LogArgs.VisualLogShapeColorValue,
-							LogArgs.bDrawWireframeValue,
-							TEXT("%s"), *Message);
-	#else
-						FVisualLogger::GeometryShapeLogf(LogArgs.VisualLoggerOwnerValue,
-							LogCategory, LogArgs.VerbosityValue,
-							LogArgs.VisualLogShapeLocationValue,
-							LogArgs.VisualLogVectorOne.X,
-							LogArgs.VisualLogVectorOne.Y,
-							LogArgs.VisualLogShapeRotationValue.Quaternion(),
-							LogArgs.VisualLogShapeColorValue,
-							TEXT("%s"), *Message);
-	#endif
-						break;
+						VisualLogShape.Output(*LogCategory, *VisualLogMessage);
 					}
+				});
 			}
 		}
 #endif
@@ -1008,6 +1734,8 @@ namespace DBG::Log
 		}
 
 
+		float NotifyDuration = 6.f;
+		EMessageSeverity::Type MessageSeverity = EMessageSeverity::Info;
 		switch (LogArgs.VerbosityValue)
 		{
 		case ELogVerbosity::Display:
@@ -1022,23 +1750,8 @@ namespace DBG::Log
 					LogArgs.ScrnDuration(10);
 				}
 
-				if (LogArgs.bLogToSlateNotify)
-				{
-					FNotificationInfo Info{FText::FromString(Message)};
-					Info.ExpireDuration = 6.f;
-					FSlateNotificationManager::Get().AddNotification(Info);
-				}
-
-				if (LogArgs.bLogToEditorMessageLog)
-				{
-					FMessageLog MsgLog(LogCategory->GetCategoryName());
-					MsgLog.Info(FText::FromString(Message));
-
-					if (LogArgs.bShowEditorMessageLogImmediately)
-					{
-						MsgLog.Open(EMessageSeverity::Type::Info);
-					}
-				}
+				NotifyDuration = 6.f;
+				MessageSeverity = EMessageSeverity::Info;
 				break;
 			}
 		case ELogVerbosity::Warning:
@@ -1053,23 +1766,8 @@ namespace DBG::Log
 					LogArgs.ScrnDuration(20);
 				}
 
-				if (LogArgs.bLogToSlateNotify)
-				{
-					FNotificationInfo Info{FText::FromString(Message)};
-					Info.ExpireDuration = 15.f;
-					FSlateNotificationManager::Get().AddNotification(Info);
-				}
-
-				if (LogArgs.bLogToEditorMessageLog)
-				{
-					FMessageLog MsgLog(LogCategory->GetCategoryName());
-					MsgLog.Warning(FText::FromString(Message));
-
-					if (LogArgs.bShowEditorMessageLogImmediately)
-					{
-						MsgLog.Open(EMessageSeverity::Type::Warning);
-					}
-				}
+				NotifyDuration = 15.f;
+				MessageSeverity = EMessageSeverity::Warning;
 				break;
 			}
 		case ELogVerbosity::Error:
@@ -1084,23 +1782,8 @@ namespace DBG::Log
 					LogArgs.ScrnDuration(30);
 				}
 
-				if (LogArgs.bLogToSlateNotify)
-				{
-					FNotificationInfo Info{FText::FromString(Message)};
-					Info.ExpireDuration = 30.f;
-					FSlateNotificationManager::Get().AddNotification(Info);
-				}
-
-				if (LogArgs.bLogToEditorMessageLog)
-				{
-					FMessageLog MsgLog(LogCategory->GetCategoryName());
-					MsgLog.Error(FText::FromString(Message));
-
-					if (LogArgs.bShowEditorMessageLogImmediately)
-					{
-						MsgLog.Open(EMessageSeverity::Type::Error);
-					}
-				}
+				NotifyDuration = 30.f;
+				MessageSeverity = EMessageSeverity::Error;
 				break;
 			}
 		case ELogVerbosity::Fatal:
@@ -1115,23 +1798,8 @@ namespace DBG::Log
 					LogArgs.ScrnDuration(30);
 				}
 
-				if (LogArgs.bLogToSlateNotify)
-				{
-					FNotificationInfo Info{FText::FromString(Message)};
-					Info.ExpireDuration = 30.f;
-					FSlateNotificationManager::Get().AddNotification(Info);
-				}
-
-				if (LogArgs.bLogToEditorMessageLog)
-				{
-					FMessageLog MsgLog(LogCategory->GetCategoryName());
-					MsgLog.Error(FText::FromString(Message));
-
-					if (LogArgs.bShowEditorMessageLogImmediately)
-					{
-						MsgLog.Open(EMessageSeverity::Type::Error);
-					}
-				}
+				NotifyDuration = 30.f;
+				MessageSeverity = EMessageSeverity::Error;
 				break;
 			}
 		default:
@@ -1147,37 +1815,50 @@ namespace DBG::Log
 					LogArgs.ScrnDuration(10);
 				}
 
-				if (LogArgs.bLogToSlateNotify)
+				NotifyDuration = 6.f;
+				MessageSeverity = EMessageSeverity::Info;
+				break;
+			}
+		}
+
+
+		// All game thread only, from any other thread they show up at the end of the frame (and so does the dialog response).
+		if (LogArgs.bLogToSlateNotify || LogArgs.bLogToEditorMessageLog || LogArgs.bLogToMessageDialog)
+		{
+			DBGLOG_TRACE_SCOPE(GameThreadOutputs);
+			GDbgLogGameThread.Run([Text = FText::FromString(Message), CategoryName = LogCategory->GetCategoryName(),
+				NotifyDuration, MessageSeverity, AppMsgType = LogArgs.AppMsgType, AppMessageResponse = MoveTemp(LogArgs.AppMessageResponse),
+				bSlateNotify = !!LogArgs.bLogToSlateNotify, bMessageLog = !!LogArgs.bLogToEditorMessageLog,
+				bOpenMessageLog = !!LogArgs.bShowEditorMessageLogImmediately, bMessageDialog = !!LogArgs.bLogToMessageDialog]()
+			{
+				if (bSlateNotify)
 				{
-					FNotificationInfo Info{FText::FromString(Message)};
-					Info.ExpireDuration = 6.f;
+					FNotificationInfo Info{Text};
+					Info.ExpireDuration = NotifyDuration;
 					FSlateNotificationManager::Get().AddNotification(Info);
 				}
 
-				if (LogArgs.bLogToEditorMessageLog)
+				if (bMessageLog)
 				{
-					FMessageLog MsgLog(LogCategory->GetCategoryName());
-					MsgLog.Info(FText::FromString(Message));
+					FMessageLog MsgLog(CategoryName);
+					MsgLog.Message(MessageSeverity, Text);
 
-					if (LogArgs.bShowEditorMessageLogImmediately)
+					if (bOpenMessageLog)
 					{
-						MsgLog.Open(EMessageSeverity::Type::Info);
+						MsgLog.Open(MessageSeverity);
 					}
 				}
-				break;
-			}
-		}
-
 
-		if (LogArgs.bLogToMessageDialog)
-		{
-			EAppReturnType::Type Response = FMessageDialog::Open(LogArgs.AppMsgType,
-				FText::FromString(Message), FText::FromName(LogCategory->GetCategoryName()));
+				if (bMessageDialog)
+				{
+					EAppReturnType::Type Response = FMessageDialog::Open(AppMsgType, Text, FText::FromName(CategoryName));
 
-			if (LogArgs.AppMessageResponse)
-			{
-				LogArgs.AppMessageResponse(Response);
-			}
+					if (AppMessageResponse)
+					{
+						AppMessageResponse(Response);
+					}
+				}
+			});
 		}
 
 		// Return early if we had no intention of logging to the screen/console
@@ -1198,55 +1879,57 @@ namespace DBG::Log
 #else
 			PIEID = UE::GetPlayInEditorID();
 #endif
-			Key = Location.line() + PIEID + UniqueIdentifier +
-				(LogArgs.ScreenKeyValue.IsSet() ? LogArgs.ScreenKeyValue.GetValue() : 0);
+			Key = HashCallsiteValue(Callsite.Hash, static_cast<uint64>(PIEID));
+			if (LogArgs.ScreenKeyValue.IsSet())
+			{
+				Key = HashCallsiteValue(Key, LogArgs.ScreenKeyValue.GetValue());
+			}
+			Key |= 1; // Zero marks a free entry in the screen message pool.
 		}
 
 
-		// This is basically UE_LOG but expanded so we dont need compile time log category stuff
-		static auto OutputLog = [](const std::source_location& Loc, const FLogCategoryBase& LC, ELogVerbosity::Type Verb, const FString& Msg)
+		// Collapse bursts of the same console message, only the message itself is compared since the prefix could hold a timestamp.
+		// The binary and deferred paths returned above without formatting anything, so there is nothing to compare for those.
+		if (bConsoleOnly && GDbgLogDedupWindowMs > 0.f && LogArgs.ResolvedStateId != INDEX_NONE)
 		{
-			static ::UE::Logging::Private::FStaticBasicLogDynamicData LOG_Dynamic;
-			static ::UE::Logging::Private::FStaticBasicLogRecord LOG_Static(TEXT("%s"),
-				Loc.file_name(), Loc.line(), Verb, LOG_Dynamic);
-
-			LOG_Static.Verbosity = Verb;
-			LOG_Static.File = Loc.file_name();
-			LOG_Static.Line = Loc.line();
-			LOG_Static.Verbosity = Verb;
+			DBGLOG_TRACE_SCOPE(Dedup);
+			const uint64 MessageHash = CityHash64WithSeed(reinterpret_cast<const char*>(MessageBuilder.GetData() + PrefixLen),
+				(MessageBuilder.Len() - PrefixLen) * sizeof(TCHAR), LogArgs.VerbosityValue);
+			const uint64 WindowCycles = static_cast<uint64>(GDbgLogDedupWindowMs / (1000.0 * FPlatformTime::GetSecondsPerCycle64()));
 
-			if ((Verb & ELogVerbosity::VerbosityMask) == ::ELogVerbosity::Fatal)
+			FDbgLogSingleton::FRepeatRun EndedRun;
+			if (GDbgLogSingleton.Deduplicate(LogArgs.ResolvedStateId, MessageHash, WindowCycles, Callsite, *LogCategory, LogArgs.VerbosityValue, EndedRun) == false)
 			{
-				::UE::Logging::Private::BasicFatalLog(LC, &LOG_Static, *Msg);
+				return;
 			}
-			else if ((Verb & ::ELogVerbosity::VerbosityMask) <= ::ELogVerbosity::VeryVerbose)
+
+			if (EndedRun.Count > 0)
 			{
-				if ((Verb & ::ELogVerbosity::VerbosityMask) <= LC.GetCompileTimeVerbosity())
+				if (EndedRun.bSameMessage)
 				{
-					if (!LC.IsSuppressed(Verb))
-					{
-						::UE::Logging::Private::BasicLog(LC, &LOG_Static, *Msg);
-					}
+					MessageBuilder.Appendf(TEXT(" (repeated x%u over %.0f ms)"), EndedRun.Count, EndedRun.Milliseconds);
+					Message = MessageBuilder.ToString();
+				}
+				else
+				{
+					TStringBuilder<64> RepeatBuilder;
+					RepeatBuilder.Appendf(TEXT("(previous message repeated x%u over %.0f ms)"), EndedRun.Count, EndedRun.Milliseconds);
+					OutputLog(*EndedRun.Callsite, *EndedRun.Category, EndedRun.Verbosity, RepeatBuilder.ToString());
 				}
 			}
-		};
-
+		}
 
 
 		switch (LogArgs.OutputDestinationValue)
 		{
 		case EDbgLogOutput::Con:
 			{
-				OutputLog(Location, (*LogCategory), LogArgs.VerbosityValue, Message);
+				OutputLog(Callsite, (*LogCategory), LogArgs.VerbosityValue, Message, Cycles, bAsyncDateTime ? &LogArgs.DateTimeFormat : nullptr);
 				break;
 			}
 		case EDbgLogOutput::Scr:
 			{
-				if (GEngine)
-				{
-					GEngine->AddOnScreenDebugMessage(Key, LogArgs.ScreenDurationValue,
-						LogArgs.ScreenColorValue, Message, true);
-				}
+				GDbgLogScreenMessages.AddOrUpdate(Key, LogArgs.ScreenDurationValue, LogArgs.ScreenColorValue, Message);
 				break;
 			}
 		case EDbgLogOutput::Both:
@@ -1254,14 +1937,10 @@ namespace DBG::Log
 				// Only output log if we arent already writing it to the msg log since that handles console outputting.
 				if (LogArgs.bLogToEditorMessageLog == false)
 				{
-					OutputLog(Location, (*LogCategory), LogArgs.VerbosityValue, Message);
+					OutputLog(Callsite, (*LogCategory), LogArgs.VerbosityValue, Message);
 				}
 
-				if (GEngine)
-				{
-					GEngine->AddOnScreenDebugMessage(Key, LogArgs.ScreenDurationValue,
-						LogArgs.ScreenColorValue, Message, true);
-				}
+				GDbgLogScreenMessages.AddOrUpdate(Key, LogArgs.ScreenDurationValue, LogArgs.ScreenColorValue, Message);
 				break;
 			}
 		}
@@ -1272,18 +1951,196 @@ namespace DBG::Log
 
 
 
+#if ENABLE_VISUAL_LOG
+	// The reason for manually calling these instead of using VLOG is that VLOG wanted to be annoying and
+	// assume our log verbosity is a constant IE `ELogVerbosity::MacroVerbosity`
+	inline void DbgLogArgs::FVisualLogShape::Output(const FLogCategoryBase& VisualLogCategory, const TCHAR* Message) const
+	{
+		switch (Shape)
+		{
+			case DbgLogArgs::EDbgVisualLogShape::None:
+				{
+					FVisualLogger::CategorizedLogf(Owner, VisualLogCategory,
+						Verbosity, TEXT("%s"), Message);
+					break;
+				}
+			case DbgLogArgs::EDbgVisualLogShape::Sphere:
+				{
+	#if UE_VERSION_NEWER_THAN(5, 4, 0)
+					FVisualLogger::SphereLogf(Owner,
+						VisualLogCategory, Verbosity,
+						Location,
+						VectorOne.X,
+						Color,
+						bWireframe,
+						TEXT("%s"), Message);
+	#else
+					FVisualLogger::GeometryShapeLogf(Owner,
+						VisualLogCategory, Verbosity,
+						Location,
+						VectorOne.X,
+						Color,
+						TEXT("%s"), Message);
+	#endif
+					break;
+				}
+			case DbgLogArgs::EDbgVisualLogShape::Box:
+				{
+	#if UE_VERSION_NEWER_THAN(5, 4, 0)
+					FVisualLogger::BoxLogf(Owner,
+						VisualLogCategory, Verbosity,
+						FBox{VectorOne, VectorTwo},
+						FMatrix{FScaleMatrix(Scale) *
+								FRotationMatrix(Rotation) *
+								FTranslationMatrix(Location)},
+						Color,
+						bWireframe,
+						TEXT("%s"), Message);
+	#else
+					FVisualLogger::GeometryBoxLogf(Owner,
+						VisualLogCategory, Verbosity,
+						FBox{VectorOne, VectorTwo},
+						FMatrix{FScaleMatrix(Scale) *
+								FRotationMatrix(Rotation) *
+								FTranslationMatrix(Location)},
+						Color,
+						TEXT("%s"), Message);
+	#endif
+					break;
+				}
+			case DbgLogArgs::EDbgVisualLogShape::Cone:
+				{
+	#if UE_VERSION_NEWER_THAN(5, 4, 0)
+					FVisualLogger::ConeLogf(Owner,
+						VisualLogCategory, Verbosity,
+						Location,
+						VectorOne,
+						VectorTwo.X,
+						VectorTwo.Y,
+						Color,
+						bWireframe,
+						TEXT("%s"), Message);
+	#else
+					FVisualLogger::GeometryShapeLogf(Owner,
+						VisualLogCategory, Verbosity,
+						Location,
+						VectorOne,
+						VectorTwo.X,
+						VectorTwo.Y,
+						Color,
+						TEXT("%s"), Message);
+	#endif
+					break;
+				}
+			case DbgLogArgs::EDbgVisualLogShape::Line:
+				{
+	#if UE_VERSION_NEWER_THAN(5, 4, 0)
+					FVisualLogger::SegmentLogf(Owner,
+						VisualLogCategory, Verbosity,
+						Location,
+						VectorOne,
+						Color,
+						static_cast<uint16>(VectorTwo.X),
+						TEXT("%s"), Message);
+	#else
+					FVisualLogger::GeometryShapeLogf(Owner,
+						VisualLogCategory, Verbosity,
+						Location,
+						VectorOne,
+						Color,
+						static_cast<uint16>(VectorTwo.X),
+						TEXT("%s"), Message);
+	#endif
+
+					break;
+				}
+			case DbgLogArgs::EDbgVisualLogShape::Arrow:
+				{
+					FVisualLogger::ArrowLogf(Owner,
+						VisualLogCategory, Verbosity,
+						Location,
+						VectorOne,
+						Color,
+						TEXT("%s"), Message);
+					break;
+				}
+			case DbgLogArgs::EDbgVisualLogShape::Disk:
+				{
+					FVisualLogger::CircleLogf(Owner,
+						VisualLogCategory, Verbosity,
+						Location,
+						VectorOne,
+						VectorTwo.X,
+						Color,
+						static_cast<uint16>(VectorTwo.Y),
+						TEXT("%s"), Message);
+					break;
+				}
+			case DbgLogArgs::EDbgVisualLogShape::Capsule:
+				{
+	#if UE_VERSION_NEWER_THAN(5, 4, 0)
+					FVisualLogger::CapsuleLogf(Owner,
+						VisualLogCategory, Verbosity,
+						Location,
+						VectorOne.X,
+						VectorOne.Y,
+						Rotation.Quaternion(),
+						Color,
+						bWireframe,
+						TEXT("%s"), Message);
+	#else
+					FVisualLogger::GeometryShapeLogf(Owner,
+						VisualLogCategory, Verbosity,
+						Location,
+						VectorOne.X,
+						VectorOne.Y,
+						Rotation.Quaternion(),
+						Color,
+						TEXT("%s"), Message);
+	#endif
+					break;
+				}
+		}
+	}
+#endif
+
+
+	template<typename FuncType>
+	void DbgLogArgs::DrawOnGameThread(const UObject* WorldContextObject, FuncType&& Draw)
+	{
+		// Same as the engine's DrawDebug* functions, nothing is drawn (or sent to the game thread) without debug drawing.
+#if ENABLE_DRAW_DEBUG
+		if (IsInGameThread())
+		{
+			if (const UWorld* W = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull))
+			{
+				Draw(W);
+			}
+			return;
+		}
+
+		GDbgLogGameThread.Run([WeakContext = TWeakObjectPtr<const UObject>(WorldContextObject), Draw = Forward<FuncType>(Draw)]()
+		{
+			if (const UWorld* W = GEngine->GetWorldFromContextObject(WeakContext.Get(), EGetWorldErrorMode::ReturnNull))
+			{
+				Draw(W);
+			}
+		});
+#endif
+	}
+
+
 	inline DbgLogArgs::ThisClass& DbgLogArgs::DrawDebugCapsule(const UObject* WorldContextObject,
 		const FVector& Center, float HalfHeight, float Radius,
 		const FQuat& Rotation, const FColor& Color, bool bPersistentLines,
 		float LifeTime, uint8 DepthPriority, float Thickness)
 	{
-		if (const UWorld* W = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull))
+		DrawOnGameThread(WorldContextObject, [=](const UWorld* W)
 		{
-			::DrawDebugCapsule(W, Center, HalfHeight, Radius,
-			                    Rotation, Color, bPersistentLines, LifeTime,
-			                    DepthPriority, Thickness);
-		}
-
+			GDbgLogDebugDraw.AddCapsule(W, Center, HalfHeight, Radius,
+			                             Rotation, Color, bPersistentLines, LifeTime,
+			                             DepthPriority, Thickness);
+		});
 		return *this;
 	}
 
@@ -1294,13 +2151,12 @@ namespace DBG::Log
 		const FColor& Color, bool bPersistentLines, float LifeTime,
 		uint8 DepthPriority, float Thickness)
 	{
-		if (const UWorld* W = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull))
+		DrawOnGameThread(WorldContextObject, [=](const UWorld* W)
 		{
-			::DrawDebugCone(W, Origin, Direction, Length,
-			                 FMath::DegreesToRadians(AngleWidth), FMath::DegreesToRadians(AngleHeight), NumSides, Color,
-			                 bPersistentLines, LifeTime, DepthPriority, Thickness);
-
-		}
+			GDbgLogDebugDraw.AddCone(W, Origin, Direction, Length,
+			                          FMath::DegreesToRadians(AngleWidth), FMath::DegreesToRadians(AngleHeight), NumSides, Color,
+			                          bPersistentLines, LifeTime, DepthPriority, Thickness);
+		});
 		return *this;
 	}
 
@@ -1310,14 +2166,12 @@ namespace DBG::Log
 		int32 Segments, const FColor& Color, bool bPersistentLines,
 		float LifeTime, uint8 DepthPriority, float Thickness)
 	{
-		if (const UWorld* W = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull))
+		DrawOnGameThread(WorldContextObject, [=](const UWorld* W)
 		{
-			::DrawDebugCylinder(W, Start, End, Radius,
-			                     Segments, Color, bPersistentLines, LifeTime,
-			                     DepthPriority, Thickness);
-		}
-
-
+			GDbgLogDebugDraw.AddCylinder(W, Start, End, Radius,
+			                              Segments, Color, bPersistentLines, LifeTime,
+			                              DepthPriority, Thickness);
+		});
 		return *this;
 	}
 
@@ -1326,12 +2180,12 @@ namespace DBG::Log
 		const FVector& LineStart, const FVector& LineEnd, float ArrowSize, const FColor& Color,
 		bool bPersistentLines, float LifeTime, uint8 DepthPriority, float Thickness)
 	{
-		if (const UWorld* W = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull))
+		DrawOnGameThread(WorldContextObject, [=](const UWorld* W)
 		{
-			::DrawDebugDirectionalArrow(W, LineStart, LineEnd, ArrowSize,
-			                             Color, bPersistentLines, LifeTime, DepthPriority,
-			                             Thickness);
-		}
+			GDbgLogDebugDraw.AddDirectionalArrow(W, LineStart, LineEnd, ArrowSize,
+			                                      Color, bPersistentLines, LifeTime, DepthPriority,
+			                                      Thickness);
+		});
 		return *this;
 	}
 
@@ -1340,12 +2194,12 @@ namespace DBG::Log
 		const FVector& LineStart, const FVector& LineEnd, const FColor& Color,
 		bool bPersistentLines, float LifeTime, uint8 DepthPriority, float Thickness)
 	{
-		if (const UWorld* W = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull))
+		DrawOnGameThread(WorldContextObject, [=](const UWorld* W)
 		{
-			::DrawDebugLine(W, LineStart, LineEnd, Color,
-			                 bPersistentLines, LifeTime, DepthPriority,
-			                 Thickness);
-		}
+			GDbgLogDebugDraw.AddLine(W, LineStart, LineEnd, Color,
+			                          bPersistentLines, LifeTime, DepthPriority,
+			                          Thickness);
+		});
 		return *this;
 	}
 
@@ -1354,11 +2208,11 @@ namespace DBG::Log
 		const FVector& Position, float Size, const FColor& Color,
 		bool bPersistentLines, float LifeTime, uint8 DepthPriority)
 	{
-		if (const UWorld* W = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull))
+		DrawOnGameThread(WorldContextObject, [=](const UWorld* W)
 		{
-			::DrawDebugPoint(W, Position, Size, Color,
-			                  bPersistentLines, LifeTime, DepthPriority);
-		}
+			GDbgLogDebugDraw.AddPoint(W, Position, Size, Color,
+			                           bPersistentLines, LifeTime, DepthPriority);
+		});
 		return *this;
 	}
 
@@ -1368,12 +2222,12 @@ namespace DBG::Log
 		bool bPersistentLines, float LifeTime, uint8 DepthPriority,
 		float Thickness)
 	{
-		if (const UWorld* W = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull))
+		DrawOnGameThread(WorldContextObject, [=](const UWorld* W)
 		{
-			::DrawDebugSphere(W, Center, Radius, Segments,
-			                   Color, bPersistentLines, LifeTime, DepthPriority,
-			                   Thickness);
-		}
+			GDbgLogDebugDraw.AddSphere(W, Center, Radius, Segments,
+			                            Color, bPersistentLines, LifeTime, DepthPriority,
+			                            Thickness);
+		});
 		return *this;
 	}
 
@@ -1382,11 +2236,11 @@ namespace DBG::Log
 		const FVector& TextLocation, const FString& Text,
 		AActor* TestBaseActor, const FColor& TextColor, float Duration)
 	{
-		if (const UWorld* W = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull))
+		DrawOnGameThread(WorldContextObject, [=, WeakTestBaseActor = TWeakObjectPtr<AActor>(TestBaseActor)](const UWorld* W)
 		{
-			::DrawDebugString(W, TextLocation, Text, TestBaseActor,
+			::DrawDebugString(W, TextLocation, Text, WeakTestBaseActor.Get(),
 			                   TextColor, Duration);
-		}
+		});
 		return *this;
 	}
 
@@ -1394,18 +2248,44 @@ namespace DBG::Log
 		const FVector& Center, const FVector& Extent, const FColor& Color,
 		bool bPersistentLines, float LifeTime, uint8 DepthPriority, float Thickness)
 	{
-		if (const UWorld* W = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull))
+		DrawOnGameThread(WorldContextObject, [=](const UWorld* W)
+		{
+			GDbgLogDebugDraw.AddBox(W, Center, Extent, Color,
+			                         bPersistentLines, LifeTime, DepthPriority, Thickness);
+		});
+		return *this;
+	}
+
+
+	inline bool DbgLogArgs::ShouldStoreVisualLog(bool bOnlyLogVisually)
+	{
+		// Only support a single visual log per macro.
+		if (VisualLoggerOwnerValue != nullptr || bVisualLogDiscarded)
 		{
-			::DrawDebugBox(W, Center, Extent, Color,
-			                bPersistentLines, LifeTime, DepthPriority, Thickness);
+			return false;
+		}
 
+		if (IsVisualLoggerRecording())
+		{
+			return true;
 		}
-		return *this;
+
+		// Would only be thrown away, if the visual logger was all this log was for ShouldLog skips it entirely.
+		bVisualLogDiscarded = true;
+		bOnlyUseVisualLogger = bOnlyLogVisually;
+		return false;
 	}
 
 
 	inline DbgLogArgs& DbgLogArgs::VisualLogText(const UObject* Owner, bool bOnlyLogVisually)
 	{
+		if (IsVisualLoggerRecording() == false)
+		{
+			bVisualLogDiscarded = true;
+			bOnlyUseVisualLogger = bOnlyLogVisually;
+			return *this;
+		}
+
 		VisualLoggerOwnerValue = Owner;
 		VisualLogShapeValue = EDbgVisualLogShape::None;
 		bOnlyUseVisualLogger = bOnlyLogVisually;
@@ -1416,8 +2296,7 @@ namespace DBG::Log
 	inline DbgLogArgs& DbgLogArgs::VisualLogSphere(const UObject* Owner, const FVector& Location, float Radius,
 		bool bDrawWireframe, bool bOnlyLogVisually)
 	{
-		// Only support a single visual log per macro.
-		if (VisualLoggerOwnerValue == nullptr)
+		if (ShouldStoreVisualLog(bOnlyLogVisually))
 		{
 			VisualLoggerOwnerValue = Owner;
 			VisualLogShapeValue = EDbgVisualLogShape::Sphere;
@@ -1436,8 +2315,7 @@ namespace DBG::Log
 		const FVector& MaxExtent, const FVector& Location, const FRotator& Rotation,
 		FColor BoxColor, bool bDrawWireframe, bool bOnlyLogVisually)
 	{
-		// Only support a single visual log per macro.
-		if (VisualLoggerOwnerValue == nullptr)
+		if (ShouldStoreVisualLog(bOnlyLogVisually))
 		{
 			VisualLoggerOwnerValue = Owner;
 			VisualLogShapeValue = EDbgVisualLogShape::Box;
@@ -1460,8 +2338,8 @@ namespace DBG::Log
 		const AActor* ActorToGetBoundsFrom, FColor BoundsColor,
 		bool bDrawWireframe, bool bOnlyLogVisually)
 	{
-		// Only support a single visual log per macro.
-		if (VisualLoggerOwnerValue == nullptr && ::IsValid(ActorToGetBoundsFrom))
+		// Checked first since the bounds aren't free to calculate.
+		if (::IsValid(ActorToGetBoundsFrom) && ShouldStoreVisualLog(bOnlyLogVisually))
 		{
 			FBox B = ActorToGetBoundsFrom->CalculateComponentsBoundingBoxInLocalSpace();
 			VisualLogBox(Owner, B.Min, B.Max, ActorToGetBoundsFrom->GetActorLocation(),
@@ -1476,8 +2354,7 @@ namespace DBG::Log
 		const FVector& Location, const FVector& Direction,
 	    float Length, float Angle, FColor ConeColor, bool bDrawWireframe, bool bOnlyLogVisually)
 	{
-		// Only support a single visual log per macro.
-		if (VisualLoggerOwnerValue == nullptr)
+		if (ShouldStoreVisualLog(bOnlyLogVisually))
 		{
 			VisualLoggerOwnerValue = Owner;
 			VisualLogShapeValue = EDbgVisualLogShape::Cone;
@@ -1500,8 +2377,7 @@ namespace DBG::Log
 		const FVector& Start, const FVector& End,
 		float Thickness, FColor LineColor,bool bOnlyLogVisually)
 	{
-		// Only support a single visual log per macro.
-		if (VisualLoggerOwnerValue == nullptr)
+		if (ShouldStoreVisualLog(bOnlyLogVisually))
 		{
 			VisualLoggerOwnerValue = Owner;
 			VisualLogShapeValue = EDbgVisualLogShape::Line;
@@ -1521,8 +2397,7 @@ namespace DBG::Log
 		const FVector& Start, const FVector& End,
 		FColor ArrowColor,bool bOnlyLogVisually)
 	{
-		// Only support a single visual log per macro.
-		if (VisualLoggerOwnerValue == nullptr)
+		if (ShouldStoreVisualLog(bOnlyLogVisually))
 		{
 			VisualLoggerOwnerValue = Owner;
 			VisualLogShapeValue = EDbgVisualLogShape::Arrow;
@@ -1541,8 +2416,7 @@ namespace DBG::Log
 		const FVector& Start, const FVector& UpDir, float Radius,
 		FColor ArrowColor, uint16 Thickness, bool bOnlyLogVisually)
 	{
-		// Only support a single visual log per macro.
-		if (VisualLoggerOwnerValue == nullptr)
+		if (ShouldStoreVisualLog(bOnlyLogVisually))
 		{
 			VisualLoggerOwnerValue = Owner;
 			VisualLogShapeValue = EDbgVisualLogShape::Disk;
@@ -1563,8 +2437,7 @@ namespace DBG::Log
 		const FVector& Base, const FRotator Rotation, float Radius,
 		float HalfHeight, FColor CapsuleColor, bool bDrawWireframe, bool bOnlyLogVisually)
 	{
-		// Only support a single visual log per macro.
-		if (VisualLoggerOwnerValue == nullptr)
+		if (ShouldStoreVisualLog(bOnlyLogVisually))
 		{
 			VisualLoggerOwnerValue = Owner;
 			VisualLogShapeValue = EDbgVisualLogShape::Capsule;
@@ -1585,7 +2458,9 @@ namespace DBG::Log
 
 #else
 	#define _INTERNAL_DBGLOGV(Args, Msg, Name, ...)
+	#define _INTERNAL_DBGLOG(Msg, Name, ...)
 	#define dbgLOG(Msg, ...)
 	#define dbgLOGV(Args, Msg, ...)
+	#define dbgLOGCT(Verb, Args, Msg, ...)
 
 #endif
@@ -36,5 +36,12 @@ public class dbgLog : ModuleRules
                 "Slate",
             }
         );
+
+        PrivateDependencyModuleNames.AddRange(
+            new string[]
+            {
+                "Projects",
+            }
+        );
     }
 }
@@ -0,0 +1,535 @@
+// Copyright ©  Jack Holland.
+//
+// DbgLOG is free software. It comes without any warranty, to the extent permitted
+// by applicable law. You can redistribute it and/or modify it under the terms
+// of the Do What The Fuck You Want To Public License, Version 2, as published
+// by Sam Hocevar:
+//
+//            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+//                    Version 2, December 2004
+//
+// Copyright (C) 2004 Sam Hocevar <sam@hocevar.net>
+//
+// Everyone is permitted to copy and distribute verbatim or modified
+// copies of this license document, and changing it is allowed as long
+// as the name is changed.
+//
+//            DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE
+//   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION
+//
+//  0. You just DO WHAT THE FUCK YOU WANT TO.
+
+// Standalone decoder for the .dbglog files written by FDbgLogBinarySink (see DbgLogBinary.cpp for the layout).
+// Doesn't depend on the engine, build it with the CMakeLists.txt next to it.
+//
+// Usage: DbgLogDecoder [--json] <file.dbglog> [output]
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+
+namespace
+{
+	constexpr uint32_t SupportedVersion = 2;
+
+	// Mirrors DBG::Log::EDbgLogBinaryArgument.
+	enum class EArgument : uint8_t
+	{
+		Bool = 1,
+		Int,
+		UInt,
+		Float,
+		Double,
+		Char,
+		String,
+	};
+
+	using FArgument = std::variant<bool, int64_t, uint64_t, float, double, wchar_t, std::wstring>;
+
+	struct FCallsite
+	{
+		uint64_t Line = 0;
+		std::string File;
+		std::wstring Format;
+	};
+
+	struct FDecodeError
+	{
+		std::string What;
+	};
+
+
+	class FReader
+	{
+	public:
+		explicit FReader(std::vector<uint8_t> InData) : Data(std::move(InData)) {}
+
+		bool AtEnd() const { return Pos >= Data.size(); }
+
+		template<typename T>
+		T Read()
+		{
+			T Value;
+			Need(sizeof(T));
+			std::memcpy(&Value, Data.data() + Pos, sizeof(T));
+			Pos += sizeof(T);
+			return Value;
+		}
+
+		uint64_t ReadVarUInt()
+		{
+			uint64_t Value = 0;
+			for (int Shift = 0; Shift < 64; Shift += 7)
+			{
+				const uint8_t Byte = Read<uint8_t>();
+				Value |= static_cast<uint64_t>(Byte & 0x7f) << Shift;
+				if ((Byte & 0x80) == 0)
+				{
+					return Value;
+				}
+			}
+			throw FDecodeError{"varint too long"};
+		}
+
+		int64_t ReadVarInt()
+		{
+			const uint64_t Value = ReadVarUInt();
+			return static_cast<int64_t>(Value >> 1) ^ -static_cast<int64_t>(Value & 1);
+		}
+
+		std::string ReadString()
+		{
+			const uint64_t Size = ReadVarUInt();
+			Need(Size);
+			std::string Value(reinterpret_cast<const char*>(Data.data() + Pos), Size);
+			Pos += Size;
+			return Value;
+		}
+
+	private:
+		void Need(uint64_t Size) const
+		{
+			if (Size > Data.size() - Pos)
+			{
+				throw FDecodeError{"unexpected end of file"};
+			}
+		}
+
+		std::vector<uint8_t> Data;
+		size_t Pos = 0;
+	};
+
+
+	void AppendCodePoint(std::wstring& Out, uint32_t CodePoint)
+	{
+		if constexpr (sizeof(wchar_t) == 2)
+		{
+			if (CodePoint >= 0x10000)
+			{
+				CodePoint -= 0x10000;
+				Out += static_cast<wchar_t>(0xD800 + (CodePoint >> 10));
+				Out += static_cast<wchar_t>(0xDC00 + (CodePoint & 0x3ff));
+				return;
+			}
+		}
+		Out += static_cast<wchar_t>(CodePoint);
+	}
+
+	std::wstring Utf8ToWide(std::string_view In)
+	{
+		std::wstring Out;
+		Out.reserve(In.size());
+		for (size_t i = 0; i < In.size();)
+		{
+			const uint8_t Lead = static_cast<uint8_t>(In[i]);
+			const int Length = Lead < 0x80 ? 1 : (Lead >> 5) == 0x6 ? 2 : (Lead >> 4) == 0xe ? 3 : (Lead >> 3) == 0x1e ? 4 : 0;
+			if (Length == 0 || i + Length > In.size())
+			{
+				Out += L'\xfffd';
+				++i;
+				continue;
+			}
+
+			uint32_t CodePoint = Length == 1 ? Lead : Lead & (0x7f >> Length);
+			for (int j = 1; j < Length; ++j)
+			{
+				CodePoint = (CodePoint << 6) | (static_cast<uint8_t>(In[i + j]) & 0x3f);
+			}
+			AppendCodePoint(Out, CodePoint);
+			i += Length;
+		}
+		return Out;
+	}
+
+	void AppendUtf8(std::string& Out, uint32_t CodePoint)
+	{
+		if (CodePoint < 0x80)
+		{
+			Out += static_cast<char>(CodePoint);
+		}
+		else if (CodePoint < 0x800)
+		{
+			Out += static_cast<char>(0xc0 | (CodePoint >> 6));
+			Out += static_cast<char>(0x80 | (CodePoint & 0x3f));
+		}
+		else if (CodePoint < 0x10000)
+		{
+			Out += static_cast<char>(0xe0 | (CodePoint >> 12));
+			Out += static_cast<char>(0x80 | ((CodePoint >> 6) & 0x3f));
+			Out += static_cast<char>(0x80 | (CodePoint & 0x3f));
+		}
+		else
+		{
+			Out += static_cast<char>(0xf0 | (CodePoint >> 18));
+			Out += static_cast<char>(0x80 | ((CodePoint >> 12) & 0x3f));
+			Out += static_cast<char>(0x80 | ((CodePoint >> 6) & 0x3f));
+			Out += static_cast<char>(0x80 | (CodePoint & 0x3f));
+		}
+	}
+
+	std::string WideToUtf8(std::wstring_view In)
+	{
+		std::string Out;
+		Out.reserve(In.size());
+		for (size_t i = 0; i < In.size(); ++i)
+		{
+			uint32_t CodePoint = static_cast<uint32_t>(In[i]);
+			if constexpr (sizeof(wchar_t) == 2)
+			{
+				if (CodePoint >= 0xD800 && CodePoint < 0xDC00 && i + 1 < In.size())
+				{
+					CodePoint = 0x10000 + ((CodePoint - 0xD800) << 10) + (static_cast<uint32_t>(In[++i]) - 0xDC00);
+				}
+			}
+			AppendUtf8(Out, CodePoint);
+		}
+		return Out;
+	}
+
+
+	FArgument ReadArgument(FReader& Reader)
+	{
+		switch (static_cast<EArgument>(Reader.Read<uint8_t>()))
+		{
+		case EArgument::Bool:	return Reader.Read<uint8_t>() != 0;
+		case EArgument::Int:	return Reader.ReadVarInt();
+		case EArgument::UInt:	return Reader.ReadVarUInt();
+		case EArgument::Float:	return Reader.Read<float>();
+		case EArgument::Double:	return Reader.Read<double>();
+		case EArgument::Char:
+		{
+			std::wstring Char;
+			AppendCodePoint(Char, static_cast<uint32_t>(Reader.ReadVarUInt()));
+			return Char.size() == 1 ? FArgument(Char[0]) : FArgument(Char);
+		}
+		case EArgument::String:	return Utf8ToWide(Reader.ReadString());
+		default:				throw FDecodeError{"unknown argument tag"};
+		}
+	}
+
+	// Formats a single argument with the spec of its replacement field, IE ".3f" for "{0:.3f}".
+	std::wstring FormatArgument(const FArgument& Argument, std::wstring_view Spec)
+	{
+		const std::wstring Field = std::wstring(L"{:") + std::wstring(Spec) + L"}";
+		return std::visit([&](const auto& Value)
+		{
+			return std::vformat(Field, std::make_wformat_args(Value));
+		}, Argument);
+	}
+
+	// std::vformat can't take a runtime amount of arguments, so walk the replacement fields ourselves.
+	std::wstring FormatMessage(std::wstring_view Format, const std::vector<FArgument>& Arguments)
+	{
+		std::wstring Out;
+		size_t NextIndex = 0;
+		for (size_t i = 0; i < Format.size(); ++i)
+		{
+			const wchar_t C = Format[i];
+			if (C == L'}' && i + 1 < Format.size() && Format[i + 1] == L'}')
+			{
+				Out += L'}';
+				++i;
+				continue;
+			}
+			if (C != L'{')
+			{
+				Out += C;
+				continue;
+			}
+			if (i + 1 < Format.size() && Format[i + 1] == L'{')
+			{
+				Out += L'{';
+				++i;
+				continue;
+			}
+
+			const size_t End = Format.find(L'}', i);
+			if (End == std::wstring_view::npos)
+			{
+				Out += Format.substr(i);
+				break;
+			}
+
+			const std::wstring_view Field = Format.substr(i + 1, End - i - 1);
+			const size_t Colon = Field.find(L':');
+			const std::wstring_view Id = Field.substr(0, Colon);
+			const std::wstring_view Spec = Colon == std::wstring_view::npos ? std::wstring_view{} : Field.substr(Colon + 1);
+
+			size_t Index = NextIndex++;
+			if (Id.empty() == false)
+			{
+				Index = 0;
+				for (const wchar_t Digit : Id)
+				{
+					Index = Index * 10 + static_cast<size_t>(Digit - L'0');
+				}
+			}
+
+			try
+			{
+				if (Index >= Arguments.size() || Spec.find(L'{') != std::wstring_view::npos)
+				{
+					throw std::format_error("unsupported field");
+				}
+				Out += FormatArgument(Arguments[Index], Spec);
+			}
+			catch (const std::format_error&)
+			{
+				// Dynamic width/precision and the like, print the field as is rather than losing the log.
+				Out += Format.substr(i, End - i + 1);
+			}
+			i = End;
+		}
+		return Out;
+	}
+
+
+	const char* VerbosityToString(uint8_t Verbosity)
+	{
+		static const char* Names[] = {"NoLogging", "Fatal", "Error", "Warning", "Display", "Log", "Verbose", "VeryVerbose"};
+		return Verbosity < std::size(Names) ? Names[Verbosity] : "Unknown";
+	}
+
+	// Same shape as the engine's log timestamps, IE "2024.01.31-13.37.00:042" (UTC).
+	std::string TicksToString(int64_t Ticks)
+	{
+		constexpr int64_t TicksPerSecond = 10'000'000;
+		constexpr int64_t UnixEpochTicks = 621'355'968'000'000'000;
+
+		const int64_t UnixTicks = Ticks - UnixEpochTicks;
+		const std::time_t Seconds = static_cast<std::time_t>(UnixTicks / TicksPerSecond);
+		const int64_t Millis = (UnixTicks % TicksPerSecond) / 10'000;
+
+		std::tm Time{};
+#if defined(_WIN32)
+		gmtime_s(&Time, &Seconds);
+#else
+		gmtime_r(&Seconds, &Time);
+#endif
+		return std::format("{:04}.{:02}.{:02}-{:02}.{:02}.{:02}:{:03}", Time.tm_year + 1900, Time.tm_mon + 1, Time.tm_mday,
+			Time.tm_hour, Time.tm_min, Time.tm_sec, Millis);
+	}
+
+	std::string JsonEscape(std::string_view In)
+	{
+		std::string Out;
+		Out.reserve(In.size() + 2);
+		for (const char C : In)
+		{
+			switch (C)
+			{
+			case '"':	Out += "\\\""; break;
+			case '\\':	Out += "\\\\"; break;
+			case '\n':	Out += "\\n"; break;
+			case '\r':	Out += "\\r"; break;
+			case '\t':	Out += "\\t"; break;
+			default:
+				if (static_cast<uint8_t>(C) < 0x20)
+				{
+					Out += std::format("\\u{:04x}", static_cast<int>(C));
+				}
+				else
+				{
+					Out += C;
+				}
+			}
+		}
+		return Out;
+	}
+
+
+	int Decode(FReader& Reader, std::FILE* Output, bool bJson)
+	{
+		char Magic[4];
+		for (char& C : Magic)
+		{
+			C = static_cast<char>(Reader.Read<uint8_t>());
+		}
+		if (std::memcmp(Magic, "DBGL", 4) != 0)
+		{
+			std::fprintf(stderr, "Not a dbglog file.\n");
+			return 1;
+		}
+
+		const uint32_t Version = Reader.Read<uint32_t>();
+		if (Version != SupportedVersion)
+		{
+			std::fprintf(stderr, "Unsupported dbglog version %u (expected %u).\n", Version, SupportedVersion);
+			return 1;
+		}
+
+		const uint64_t StartCycles = Reader.Read<uint64_t>();
+		const double SecondsPerCycle = Reader.Read<double>();
+		const int64_t StartTicks = Reader.Read<int64_t>();
+
+		std::unordered_map<uint64_t, FCallsite> Callsites;
+		std::unordered_map<uint64_t, std::string> Categories;
+		std::vector<FArgument> Arguments;
+		uint64_t Cycles = StartCycles;
+
+		while (Reader.AtEnd() == false)
+		{
+			const uint8_t Kind = Reader.Read<uint8_t>();
+			if (Kind == 'C')
+			{
+				const uint64_t Id = Reader.ReadVarUInt();
+				FCallsite& Callsite = Callsites[Id];
+				Callsite.Line = Reader.ReadVarUInt();
+				Callsite.File = Reader.ReadString();
+				Callsite.Format = Utf8ToWide(Reader.ReadString());
+				continue;
+			}
+			if (Kind == 'K')
+			{
+				const uint64_t Id = Reader.ReadVarUInt();
+				Categories[Id] = Reader.ReadString();
+				continue;
+			}
+			if (Kind != 'L')
+			{
+				throw FDecodeError{"unknown entry kind"};
+			}
+
+			const uint64_t Id = Reader.ReadVarUInt();
+			const uint64_t CategoryId = Reader.ReadVarUInt();
+			Cycles += static_cast<uint64_t>(Reader.ReadVarInt());
+			const uint8_t Verbosity = Reader.Read<uint8_t>();
+			const std::wstring Prefix = Utf8ToWide(Reader.ReadString());
+
+			Arguments.clear();
+			const uint8_t NumArguments = Reader.Read<uint8_t>();
+			for (uint8_t Index = 0; Index < NumArguments; ++Index)
+			{
+				Arguments.push_back(ReadArgument(Reader));
+			}
+
+			const auto Found = Callsites.find(Id);
+			if (Found == Callsites.end())
+			{
+				throw FDecodeError{"log references an unknown callsite"};
+			}
+			const FCallsite& Callsite = Found->second;
+
+			const auto FoundCategory = Categories.find(CategoryId);
+			if (FoundCategory == Categories.end())
+			{
+				throw FDecodeError{"log references an unknown category"};
+			}
+			const std::string& Category = FoundCategory->second;
+
+			const double Seconds = static_cast<double>(static_cast<int64_t>(Cycles - StartCycles)) * SecondsPerCycle;
+			const std::string Time = TicksToString(StartTicks + static_cast<int64_t>(Seconds * 10'000'000.0));
+			const std::string Message = WideToUtf8(Prefix + FormatMessage(Callsite.Format, Arguments));
+
+			std::string Line;
+			if (bJson)
+			{
+				Line = std::format(R"({{"time":"{}","category":"{}","verbosity":"{}","file":"{}","line":{},"message":"{}"}})",
+					Time, JsonEscape(Category), VerbosityToString(Verbosity), JsonEscape(Callsite.File), Callsite.Line,
+					JsonEscape(Message));
+			}
+			else if (Verbosity == 5) // Log, the engine doesn't print it either.
+			{
+				Line = std::format("[{}]{}: {}", Time, Category, Message);
+			}
+			else
+			{
+				Line = std::format("[{}]{}: {}: {}", Time, Category, VerbosityToString(Verbosity), Message);
+			}
+			Line += '\n';
+			std::fwrite(Line.data(), 1, Line.size(), Output);
+		}
+		return 0;
+	}
+}
+
+
+int main(int Argc, char** Argv)
+{
+	bool bJson = false;
+	std::vector<const char*> Paths;
+	for (int Index = 1; Index < Argc; ++Index)
+	{
+		if (std::strcmp(Argv[Index], "--json") == 0)
+		{
+			bJson = true;
+		}
+		else
+		{
+			Paths.push_back(Argv[Index]);
+		}
+	}
+
+	if (Paths.empty() || Paths.size() > 2)
+	{
+		std::fprintf(stderr, "Usage: %s [--json] <file.dbglog> [output]\n", Argv[0]);
+		return 2;
+	}
+
+	std::ifstream Input(Paths[0], std::ios::binary);
+	if (!Input)
+	{
+		std::fprintf(stderr, "Failed to open %s\n", Paths[0]);
+		return 1;
+	}
+	FReader Reader{std::vector<uint8_t>(std::istreambuf_iterator<char>(Input), std::istreambuf_iterator<char>())};
+
+	std::FILE* Output = stdout;
+	if (Paths.size() == 2)
+	{
+		Output = std::fopen(Paths[1], "wb");
+		if (Output == nullptr)
+		{
+			std::fprintf(stderr, "Failed to open %s\n", Paths[1]);
+			return 1;
+		}
+	}
+
+	int Result = 0;
+	try
+	{
+		Result = Decode(Reader, Output, bJson);
+	}
+	catch (const FDecodeError& Error)
+	{
+		// Files from a crashed session are usually cut off mid record, keep everything before that.
+		std::fprintf(stderr, "Stopped decoding: %s\n", Error.What.c_str());
+		Result = 1;
+	}
+
+	if (Output != stdout)
+	{
+		std::fclose(Output);
+	}
+	return Result;
+}